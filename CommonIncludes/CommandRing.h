@@ -0,0 +1,60 @@
+#ifndef COMMANDRING_H
+#define COMMANDRING_H
+
+/**
+ * @file CommandRing.h
+ * @brief Lock-free operations on the #COMMAND_RING shared through the `robot_in` page.
+ *
+ * Only the pick-trigger-app may call #commandRingPush and only the pick-robot may
+ * 	call #commandRingPending and #commandRingPop. Neither side ever blocks.
+ */
+
+#include "SharedMemoryStructs.h"
+
+/**
+ * @fn commandRingPush
+ * @brief Queue a command for the pick-robot.
+ * @param[in] ring The shared ring.
+ * @param[in] command The command to queue.
+ * @return Whether the command was queued. If the ring is full the command is
+ * 	dropped and #COMMAND_RING::dropped is incremented.
+ */
+static inline bool commandRingPush(COMMAND_RING *ring, const COMMAND_STRUCT *command) {
+	unsigned int head = ring->head;
+	unsigned int tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	if (head - tail >= COMMAND_RING_SIZE) {
+		__atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+		return false;
+	}
+	ring->commands[head & (COMMAND_RING_SIZE - 1)] = *command;
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/**
+ * @fn commandRingPending
+ * @param[in] ring The shared ring.
+ * @return The number of commands waiting to be popped.
+ */
+static inline unsigned int commandRingPending(COMMAND_RING *ring) {
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - ring->tail;
+}
+
+/**
+ * @fn commandRingPop
+ * @brief Take the oldest queued command.
+ * @param[in] ring The shared ring.
+ * @param[out] command The popped command.
+ * @return Whether a command was available.
+ */
+static inline bool commandRingPop(COMMAND_RING *ring, COMMAND_STRUCT *command) {
+	unsigned int tail = ring->tail;
+	if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail) {
+		return false;
+	}
+	*command = ring->commands[tail & (COMMAND_RING_SIZE - 1)];
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+#endif /* COMMANDRING_H */
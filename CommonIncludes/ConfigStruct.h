@@ -6,6 +6,16 @@
  */
 
 
+/**
+ * Order the locations of a box layer are picked in
+ */
+enum PICK_ORDER {
+	PO_RASTER,			/**< Row by row from the box start */
+	PO_NEAREST,			/**< The shortest trip from the gripper's position to the location and the drop location first */
+	PO_HIGHEST,			/**< The highest estimated pile first, experimental */
+	NUM_PICK_ORDERS
+};
+
 /**
  * @typedef Target Gereration Config
  * @brief Coordinates that determine box dimensions, drop location, and distance between picks.
@@ -15,8 +25,34 @@ typedef struct {
 	int boxEnd[3];				/**< The end of the box (XYZ) */
 	int delta[3];				/**< The dimensions of the items to be picked */
 	int dropLocation[3];		/**< The desired drop location (XYZ) */
+	int pickOrder;				/**< The #PICK_ORDER of each layer */
 } TARGET_GENERATOR_CONFIG;
 
+/**
+ * @def DEFAULT_STEPS_PER_SEC2
+ * The L6470 acceleration and deceleration after a reset, in steps/second².
+ */
+#define DEFAULT_STEPS_PER_SEC2 2008
+
+/**
+ * @def DEFAULT_HOMING_STEPS_PER_SEC
+ * The speed an axis approaches its limit switch at before it has been found, in steps/second.
+ */
+#define DEFAULT_HOMING_STEPS_PER_SEC 800
+
+/**
+ * @def DEFAULT_HOMING_CREEP_STEPS_PER_SEC
+ * The speed an axis re-approaches its limit switch at to set home, in steps/second.
+ */
+#define DEFAULT_HOMING_CREEP_STEPS_PER_SEC 200
+
+/**
+ * @def HOMING_MAX_STEPS_PER_SEC
+ * The fastest an axis approaches its limit switch, in steps/second. Homing releases the
+ * 	switch at MIN_SPEED, whose 12 bit register holds at most 0xFFF / 4.1943 steps/second.
+ */
+#define HOMING_MAX_STEPS_PER_SEC 976
+
 /**
  * @typedef Motor Configuration
  * @brief Configuration of the motor that determines motor ID, speeds/accel (max/min), and steps.
@@ -29,6 +65,8 @@ typedef struct {
 	int holdCurrent;		/**< Passed current used to hold the motor steady */
 	int runCurrent;			/**< Passed current used to move the motor */
 	int maxStepsPerSec;		/**< Max steps the motor can take per second */
+	int accelStepsPerSec2;	/**< Acceleration in steps/second² */
+	int decelStepsPerSec2;	/**< Deceleration in steps/second² */
 	int stepsPerRev;		/**< Steps necessary for one revolution of motor */
 	double mmPerRev;		/**< Millimeters traveled per motor revolution */
 	bool invert;			/**< Slushengine: invert the commanded motor direction */
@@ -44,6 +82,8 @@ typedef struct {
 	char axisLabel;			/**< Label of axis */
 	int stagingArea;		/**< Desired staging area for axis */
 	int travelLimitmm;		/**< Travel limits of axis */
+	int homingStepsPerSec;	/**< Speed of the first, fast approach to the limit switch, at most #HOMING_MAX_STEPS_PER_SEC */
+	int homingCreepStepsPerSec;	/**< Speed of the second, slow approach that sets home, at most #HOMING_MAX_STEPS_PER_SEC */
 } AXIS_CONFIG;
 
 /**
@@ -56,6 +96,9 @@ typedef struct {
 	bool logAxesData;		/**< Is the pick-robot recording all axes motion */
 	bool ignoreErrorFlags;	/**< Is the pick-robot ignoring error messages */
 	bool emergencyStop; 	/**< Has an emergency stop been commanded */
+	int realtimeCpu;		/**< Core the real-time loop is pinned to, the other processes avoid it (-1: last core) */
+	float simSpeedup;		/**< Simulated ticks run this many times faster than real time (0: as fast as possible), ignored unless simulating without realtime */
+	bool blendMotion;		/**< Does the pick cycle overlap Z and XY moves inside the box's safety envelopes */
 } RUNTIME_FLAGS;
 
 /**
@@ -0,0 +1,64 @@
+#ifndef LOOPSTATS_H
+#define LOOPSTATS_H
+
+/**
+ * @file LoopStats.h
+ * @brief Recording into and querying the #LOOP_HISTOGRAM published in #ROBOT_OUT.
+ */
+
+#include "SharedMemoryStructs.h"
+
+/**
+ * @fn loopHistogramRecord
+ * @brief Count one sample. Constant time, suitable for the real-time loop.
+ * @param[in,out] histogram The histogram.
+ * @param[in] ns The sample, in nanoseconds.
+ */
+static inline void loopHistogramRecord(LOOP_HISTOGRAM *histogram, long ns) {
+	unsigned long us = ns > 0 ? ns / 1000 : 0;
+	int bucket = us == 0 ? 0 : 32 - __builtin_clz((unsigned int) us);
+	if (bucket >= LOOP_HISTOGRAM_BUCKETS) {
+		bucket = LOOP_HISTOGRAM_BUCKETS - 1;
+	}
+	histogram->buckets[bucket]++;
+	if (ns > histogram->maxNs) {
+		histogram->maxNs = ns;
+	}
+}
+
+/**
+ * @fn loopHistogramBucketLimit
+ * @param[in] bucket A bucket index.
+ * @return The exclusive upper bound of @p bucket, in microseconds.
+ */
+static inline unsigned long loopHistogramBucketLimit(int bucket) {
+	return 1UL << bucket;
+}
+
+/**
+ * @fn loopHistogramPercentile
+ * @param[in] histogram The histogram.
+ * @param[in] fraction The percentile, between 0 and 1 (e.g. 0.99).
+ * @return The upper bound, in microseconds, of the bucket holding the percentile,
+ * 	or 0 if the histogram is empty.
+ */
+static inline unsigned long loopHistogramPercentile(const LOOP_HISTOGRAM *histogram, double fraction) {
+	unsigned long long total = 0;
+	for (int bucket = 0; bucket < LOOP_HISTOGRAM_BUCKETS; bucket++) {
+		total += histogram->buckets[bucket];
+	}
+	if (total == 0) {
+		return 0;
+	}
+	unsigned long long rank = (unsigned long long) (fraction * total);
+	unsigned long long seen = 0;
+	for (int bucket = 0; bucket < LOOP_HISTOGRAM_BUCKETS; bucket++) {
+		seen += histogram->buckets[bucket];
+		if (seen > rank) {
+			return loopHistogramBucketLimit(bucket);
+		}
+	}
+	return loopHistogramBucketLimit(LOOP_HISTOGRAM_BUCKETS - 1);
+}
+
+#endif /* LOOPSTATS_H */
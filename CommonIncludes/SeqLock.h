@@ -0,0 +1,68 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+/**
+ * @file SeqLock.h
+ * @brief A single-writer sequence lock for structures shared between the
+ * 	Pick-Robot and the Pick-Trigger-App.
+ *
+ * The writer never blocks: it makes #SEQLOCK::sequence odd, copies the payload,
+ * 	then makes it even again. A reader samples the sequence before and after its
+ * 	copy; if the sequence was odd or changed in between, the copy may be torn and
+ * 	must be discarded. Readers decide for themselves whether to retry, so the
+ * 	real-time side can simply skip a torn read and pick the data up next tick.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @def SEQLOCK_READ_ATTEMPTS
+ * @brief Number of attempts a non real-time reader makes before giving up on a snapshot.
+ */
+#define SEQLOCK_READ_ATTEMPTS 4
+
+/**
+ * @typedef Sequence Lock
+ * @brief Generation counter guarding a shared payload (odd while a write is in progress).
+ */
+typedef struct {
+	unsigned int sequence;		/**< Generation counter, odd while the writer is copying */
+} SEQLOCK;
+
+/**
+ * @fn seqlockWrite
+ * @brief Publish @p size bytes from @p src into the shared @p dst.
+ * @param[in] lock The lock guarding @p dst.
+ * @param[out] dst The shared payload.
+ * @param[in] src The local copy to publish.
+ * @param[in] size The size of the payload in bytes.
+ */
+static inline void seqlockWrite(SEQLOCK *lock, void *dst, const void *src, size_t size) {
+	unsigned int sequence = __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED);
+	__atomic_store_n(&lock->sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(dst, src, size);
+	__atomic_store_n(&lock->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @fn seqlockTryRead
+ * @brief Make a single attempt at copying a consistent snapshot of @p src.
+ * @param[in] lock The lock guarding @p src.
+ * @param[out] dst The local copy to fill.
+ * @param[in] src The shared payload.
+ * @param[in] size The size of the payload in bytes.
+ * @return Whether @p dst holds a consistent snapshot. On failure @p dst may be torn.
+ */
+static inline bool seqlockTryRead(SEQLOCK *lock, void *dst, const void *src, size_t size) {
+	unsigned int start = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE);
+	if (start & 1) {
+		return false;
+	}
+	memcpy(dst, src, size);
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) == start;
+}
+
+#endif /* SEQLOCK_H */
@@ -0,0 +1,103 @@
+#ifndef SHAREDEVENT_H
+#define SHAREDEVENT_H
+
+/**
+ * @file SharedEvent.h
+ * @brief A futex based wakeup shared between the Pick-Robot and the Pick-Trigger-App.
+ *
+ * The signalling side bumps #SHARED_EVENT::sequence and only enters the kernel
+ * 	when somebody is registered in #SHARED_EVENT::waiters, so the real-time loop
+ * 	can signal every tick for the cost of two atomics. The waiting side remembers
+ * 	the last sequence it acted on and sleeps until it changes or a deadline passes.
+ * 	The futex lives in shared memory, so the non-private futex operations are used.
+ * 	Hosts without futexes (the macOS LocalDebug build) poll #SHARED_EVENT::sequence
+ * 	every #SHARED_EVENT_POLL_NS instead.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+/** Interval at which hosts without futexes check for a signal. */
+#define SHARED_EVENT_POLL_NS 1000000
+
+/**
+ * @typedef Shared Event
+ * @brief Futex word and waiter count placed in a shared memory segment.
+ */
+typedef struct {
+	unsigned int sequence;		/**< Bumped on every signal, the futex word */
+	unsigned int waiters;		/**< Number of threads sleeping (or about to sleep) on #sequence */
+} SHARED_EVENT;
+
+/**
+ * @fn sharedEventSequence
+ * @param[in] event The shared event.
+ * @return The current sequence, to be passed to #sharedEventWait once acted upon.
+ */
+static inline unsigned int sharedEventSequence(SHARED_EVENT *event) {
+	return __atomic_load_n(&event->sequence, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @fn sharedEventSignal
+ * @brief Wake every waiter. Never blocks and skips the system call when nobody waits.
+ * @param[in] event The shared event.
+ */
+static inline void sharedEventSignal(SHARED_EVENT *event) {
+	__atomic_add_fetch(&event->sequence, 1, __ATOMIC_SEQ_CST);
+#ifdef __linux__
+	if (__atomic_load_n(&event->waiters, __ATOMIC_SEQ_CST) != 0) {
+		syscall(SYS_futex, &event->sequence, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+	}
+#endif
+}
+
+/**
+ * @fn sharedEventWait
+ * @brief Sleep until the sequence moves past @p seen or @p deadline passes.
+ *
+ * Like clock_nanosleep, the result is 0 or an error number, so a failing wait
+ * 	is never mistaken for a signal and spun on.
+ * @param[in] event The shared event.
+ * @param[in] seen The last sequence acted upon.
+ * @param[in] deadline Absolute CLOCK_MONOTONIC time to give up at.
+ * @return 0 if signalled (or already signalled), ETIMEDOUT if the deadline passed,
+ * 	EINTR if interrupted by a signal handler, otherwise the errno of the failed wait.
+ */
+static inline int sharedEventWait(SHARED_EVENT *event, unsigned int seen, const struct timespec *deadline) {
+#ifdef __linux__
+	__atomic_add_fetch(&event->waiters, 1, __ATOMIC_SEQ_CST);
+	long ret = syscall(SYS_futex, &event->sequence, FUTEX_WAIT_BITSET, seen, deadline, NULL,
+			FUTEX_BITSET_MATCH_ANY);
+	int error = errno;
+	__atomic_sub_fetch(&event->waiters, 1, __ATOMIC_SEQ_CST);
+	if (ret == 0 || error == EAGAIN) {
+		//EAGAIN: the sequence had already moved past seen
+		return 0;
+	}
+	return error;
+#else
+	while (sharedEventSequence(event) == seen) {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		long long remaining = (long long) (deadline->tv_sec - now.tv_sec) * 1000000000LL
+				+ (deadline->tv_nsec - now.tv_nsec);
+		if (remaining <= 0) {
+			return ETIMEDOUT;
+		}
+		struct timespec poll = { 0, remaining < SHARED_EVENT_POLL_NS ? (long) remaining : SHARED_EVENT_POLL_NS };
+		if (nanosleep(&poll, NULL) != 0) {
+			return errno;
+		}
+	}
+	return 0;
+#endif
+}
+
+#endif /* SHAREDEVENT_H */
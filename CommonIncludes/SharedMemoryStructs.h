@@ -6,6 +6,8 @@
  */
 
 #include "ConfigStruct.h"
+#include "SeqLock.h"
+#include "SharedEvent.h"
 
 /**
  * @def SEC_TO_MILL
@@ -79,6 +81,7 @@ enum ERROR_STATUS {
 	ES_SENSOR_STALL_DETECTED_ON_B,		/**< Slushengine: Speed and/or load angle caused motor stall on B */
 	ES_AXIS_TARGET_OUT_OF_BOUNDS,		/**< Desired target is beyond axis limits */
 	ES_VACUUM_SENSOR_MISREAD,			/**< Incorrect suction value is read (based on suction value and vacuum state) */
+	ES_IO_REQUEST_DROPPED,				/**< The I/O worker's request ring was full, a motor or gripper request was lost */
 	ES_NUM_OF_FLAGS						/**< The number of possible error flags */
 };
 
@@ -176,6 +179,7 @@ typedef struct {
 typedef struct {
 	int targetPosition[3];		/**< The target axis position */
 	int axisPosition[3];		/**< The current axis position */
+	int etaMs[3];				/**< Predicted milliseconds until each axis reaches its target */
 	bool isBusy;				/**< Is the current axis already in motion */
 } AXIS_STATUS;
 
@@ -187,6 +191,14 @@ typedef struct {
 	long int itemsPicked;		/**< The number of items successfully picked */
 } PC_STATUS;
 
+/**
+ * @typedef Zero Return Status
+ */
+typedef struct {
+	bool isHoming;				/**< Is a zero return in progress */
+	long homingMs;				/**< Milliseconds the zero return in progress has taken so far, or the last one took */
+} ZR_STATUS;
+
 /**
  * @typedef Vacuum Information
  */
@@ -196,6 +208,107 @@ typedef struct {
 	SUCTION suctionStatus;		/**< The current suction status */
 } VAC_STATUS;
 
+/**
+ * @typedef Real-time Status
+ * @brief Real-time guarantees obtained by the pick-robot before entering its loop
+ */
+typedef struct {
+	bool memoryLocked;			/**< All current and future pages are locked (mlockall) */
+	bool stackPrefaulted;		/**< The stack has been touched while locked */
+	bool heapPrefaulted;		/**< The heap has been grown, touched while locked and is never trimmed */
+	bool cpuPinned;				/**< The real-time loop only runs on #cpu */
+	bool cpuIsolated;			/**< #cpu is isolated from the scheduler (isolcpus), informational */
+	bool priorityFifo;			/**< The real-time loop runs under SCHED_FIFO */
+	int cpu;					/**< The core the real-time loop is pinned to */
+	unsigned int scheduleBudgetUs;		/**< Worst case component time allowed per tick */
+	unsigned int scheduleWorstTickUs;	/**< Worst case component time of the busiest scheduled tick */
+} REALTIME_STATUS;
+
+/**
+ * @typedef Inter-Process Communication Status
+ */
+typedef struct {
+	long tornReads;				/**< #JSON_CONFIG snapshots discarded by the pick-robot because they were mid-write */
+	long commandsProcessed;		/**< Commands drained from the #COMMAND_RING by the pick-robot */
+	long commandsDropped;		/**< Commands the pick-trigger-app could not queue because the #COMMAND_RING was full */
+	long historyRecords;		/**< Records appended to the #TELEMETRY_HISTORY by the pick-robot */
+} IPC_STATUS;
+
+/**
+ * @def LOOP_HISTOGRAM_BUCKETS
+ * @brief Number of log-scale buckets in a #LOOP_HISTOGRAM.
+ */
+#define LOOP_HISTOGRAM_BUCKETS 20
+
+/**
+ * @typedef Loop Histogram
+ * @brief Log-scale histogram of durations measured by the real-time loop
+ *
+ * Bucket 0 counts durations under 1 us, bucket `n` counts durations in
+ * 	[2^(n-1), 2^n) us, and the last bucket also counts everything longer.
+ */
+typedef struct {
+	unsigned int buckets[LOOP_HISTOGRAM_BUCKETS];	/**< Samples per bucket */
+	long maxNs;										/**< Longest sample, in nanoseconds */
+} LOOP_HISTOGRAM;
+
+/**
+ * @typedef Loop Statistics
+ * @brief Timing of the pick-robot's real-time loop since it started
+ */
+typedef struct {
+	long ticks;						/**< Ticks measured */
+	long overruns;					/**< Ticks that finished after the next tick was due */
+	LOOP_HISTOGRAM wakeupLatency;	/**< Time from a tick's deadline to the loop waking up */
+	LOOP_HISTOGRAM execution;		/**< Time from waking up to the end of the tick's work */
+	long busTransactions;			/**< SPI and I2C transactions the I/O worker issued while the loop ran */
+	unsigned int busTransactionsMax;	/**< Most bus transactions seen in one tick */
+	unsigned int ioRequestsDropped;	/**< Requests the I/O worker's ring was too full to take */
+} LOOP_STATS;
+
+/**
+ * @def MAX_PROFILED_COMPONENTS
+ * @brief Number of components the #COMPONENT_PROFILES can report.
+ */
+#define MAX_PROFILED_COMPONENTS 16
+
+/**
+ * @def PROFILE_NAME_LENGTH
+ * @brief Length of a #COMPONENT_PROFILE::name, including the terminator.
+ */
+#define PROFILE_NAME_LENGTH 16
+
+/**
+ * @typedef Profile Statistics
+ * @brief Execution time of one call site over one profiling window, in nanoseconds
+ */
+typedef struct {
+	unsigned int minNs;			/**< Fastest call */
+	unsigned int avgNs;			/**< Mean call */
+	unsigned int maxNs;			/**< Slowest call */
+	unsigned int p99Ns;			/**< Upper bound of the (power of two) bucket holding the 99th percentile */
+} PROFILE_STATS;
+
+/**
+ * @typedef Component Profile
+ */
+typedef struct {
+	char name[PROFILE_NAME_LENGTH];	/**< The component's name */
+	PROFILE_STATS step;				/**< Time spent in ComponentInterface::step */
+	PROFILE_STATS report;			/**< Time spent in ComponentInterface::reportStatus */
+} COMPONENT_PROFILE;
+
+/**
+ * @typedef Component Profiles
+ * @brief Per-component execution times over the last complete profiling window
+ */
+typedef struct {
+	unsigned int window;								/**< Number of windows completed, 0 until the first one is */
+	unsigned int windowTicks;							/**< Ticks per window */
+	int numberOfComponents;								/**< Valid entries in #components */
+	COMPONENT_PROFILE components[MAX_PROFILED_COMPONENTS];	/**< The profiled components, in tick order */
+} COMPONENT_PROFILES;
+
 /**
  * @typedef Pick-Robot Command Structure
  */
@@ -205,14 +318,25 @@ typedef struct {
 } COMMAND_STRUCT;
 
 /**
- * @typedef Robot In
- * @brief Information receive by the pick-robot
+ * @def COMMAND_RING_SIZE
+ * @brief Capacity of the #COMMAND_RING (must be a power of two).
+ */
+#define COMMAND_RING_SIZE 32
+
+/**
+ * @typedef Command Ring
+ * @brief Single-producer/single-consumer queue of commands for the pick-robot
+ *
+ * The pick-trigger-app is the only producer and advances #head; the pick-robot is
+ * 	the only consumer and advances #tail. Both indices run freely and are reduced
+ * 	modulo #COMMAND_RING_SIZE when indexing #commands.
  */
 typedef struct {
-	COMMAND_STRUCT commandStruct;	/**< The command structure */
-	JSON_CONFIG config;				/**< The pick-robot configuration */
-	long block_number;				/**< The current block number */
-} ROBOT_IN;
+	unsigned int head __attribute__((aligned(64)));		/**< Next slot to write (producer owned) */
+	unsigned int dropped;								/**< Commands refused because the ring was full (producer owned) */
+	unsigned int tail __attribute__((aligned(64)));		/**< Next slot to read (consumer owned) */
+	COMMAND_STRUCT commands[COMMAND_RING_SIZE] __attribute__((aligned(64)));	/**< The queued commands */
+} COMMAND_RING;
 
 /**
  * @typedef Robot Out
@@ -224,8 +348,84 @@ typedef struct {
 	OPERATING_ERRORS operatingErrors;		/**< Current operating errors */
 	AXIS_STATUS axisStatus;					/**< Current axis status */
 	PC_STATUS pc_status; 					/**< Current pick control status */
+	ZR_STATUS zrStatus;						/**< Current zero return status */
 	VAC_STATUS vacStatus;					/**< Current vacuum control status */
+	REALTIME_STATUS rtStatus;				/**< Real-time guarantees obtained at startup */
+	IPC_STATUS ipcStatus;					/**< Current shared memory status */
+	LOOP_STATS loopStats;					/**< Real-time loop timing */
+	COMPONENT_PROFILES profiles;			/**< Per-component timing */
 	long block_number;						/**< Current block number */
 } ROBOT_OUT;
 
+/**
+ * @def TELEMETRY_HISTORY_SIZE
+ * @brief Number of ticks kept in the #TELEMETRY_HISTORY (must be a power of two).
+ */
+#define TELEMETRY_HISTORY_SIZE 4096
+
+/**
+ * @typedef Telemetry Record
+ * @brief Compact per-tick snapshot of #ROBOT_OUT appended to the #TELEMETRY_HISTORY
+ */
+typedef struct {
+	long block_number;					/**< The #ROBOT_OUT::block_number this record was taken from */
+	int axisPosition[3];				/**< The current axis position */
+	int targetPosition[3];				/**< The target axis position */
+	int itemsPicked;					/**< The number of items successfully picked */
+	float sensorValue;					/**< The current read suction value */
+	unsigned char pickState;			/**< The current #PICK_STATE */
+	unsigned char suctionStatus;		/**< The current #SUCTION status */
+	unsigned char priorityError;		/**< The most critical reported #ERROR_LEVEL */
+	bool isBusy;						/**< Is the current axis already in motion */
+	bool isVacuumOn;					/**< Is the vacuum currently on */
+	bool emergencyStop;					/**< Has an emergency stop been issued */
+} TELEMETRY_RECORD;
+
+/**
+ * @typedef Telemetry History
+ * @brief Layout of the `robot_history` shared memory segment
+ *
+ * The pick-robot appends one #TELEMETRY_RECORD per tick and never waits on readers.
+ * 	#head runs freely; record `n` lives in `records[n % TELEMETRY_HISTORY_SIZE]`
+ * 	until it is overwritten by record `n + TELEMETRY_HISTORY_SIZE`. Each reader keeps
+ * 	its own cursor (see TelemetryHistory.h) and detects when it has been lapped.
+ */
+typedef struct {
+	unsigned int head __attribute__((aligned(64)));		/**< Number of records ever appended */
+	TELEMETRY_RECORD records[TELEMETRY_HISTORY_SIZE] __attribute__((aligned(64)));	/**< The most recent records */
+} TELEMETRY_HISTORY;
+
+/**
+ * @typedef Robot In Segment
+ * @brief Layout of the `robot_in` shared memory page, read by the pick-robot every tick
+ */
+typedef struct {
+	SHARED_EVENT commandEvent;		/**< Signalled by the pick-trigger-app after queuing into #commands */
+	COMMAND_RING commands;			/**< Commands queued by the pick-trigger-app */
+} ROBOT_IN_SEGMENT;
+
+/**
+ * @typedef Robot Config Segment
+ * @brief Layout of the `robot_config` shared memory segment
+ *
+ * The pick-trigger-app publishes #config under #lock, then #hash. The pick-robot
+ * 	compares #hash with the hash of its own copy every tick and only copies
+ * 	#config when they differ.
+ */
+typedef struct {
+	size_t hash;					/**< #JSON_CONFIG::hash of the last completely published #config */
+	SEQLOCK lock;					/**< Guards #config, written by the pick-trigger-app */
+	JSON_CONFIG config;				/**< The latest published pick-robot configuration */
+} ROBOT_CONFIG_SEGMENT;
+
+/**
+ * @typedef Robot Out Segment
+ * @brief Layout of the `robot_out` shared memory page
+ */
+typedef struct {
+	SEQLOCK lock;					/**< Guards #block, written by the pick-robot */
+	ROBOT_OUT block;				/**< The latest published #ROBOT_OUT */
+	SHARED_EVENT statusEvent;		/**< Signalled by the pick-robot when #block changes beyond its counters */
+} ROBOT_OUT_SEGMENT;
+
 #endif /* SHAREDMEMORYSTRUCTS_H */
@@ -0,0 +1,78 @@
+#ifndef TELEMETRYHISTORY_H
+#define TELEMETRYHISTORY_H
+
+/**
+ * @file TelemetryHistory.h
+ * @brief Lock-free operations on the #TELEMETRY_HISTORY shared through the `robot_history` segment.
+ *
+ * Only the pick-robot may call #telemetryHistoryAppend. Any number of readers may
+ * 	call #telemetryHistoryRead, each with its own cursor; readers never slow the
+ * 	writer down, so a reader that falls more than #TELEMETRY_HISTORY_SIZE records
+ * 	behind loses the oldest ones and is told how many.
+ */
+
+#include "SharedMemoryStructs.h"
+
+/**
+ * @fn telemetryHistoryAppend
+ * @brief Publish the next record.
+ * @param[in] history The shared history.
+ * @param[in] record The record to append.
+ */
+static inline void telemetryHistoryAppend(TELEMETRY_HISTORY *history, const TELEMETRY_RECORD *record) {
+	unsigned int head = history->head;
+	history->records[head & (TELEMETRY_HISTORY_SIZE - 1)] = *record;
+	__atomic_store_n(&history->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @fn telemetryHistoryHead
+ * @param[in] history The shared history.
+ * @return The cursor of the next record to be appended. New readers start here.
+ */
+static inline unsigned int telemetryHistoryHead(TELEMETRY_HISTORY *history) {
+	return __atomic_load_n(&history->head, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @fn telemetryHistoryRead
+ * @brief Copy the records appended since @p cursor, oldest first.
+ * @param[in] history The shared history.
+ * @param[in,out] cursor The reader's cursor, advanced past the records consumed.
+ * @param[out] records Destination for at most @p max records.
+ * @param[in] max The capacity of @p records.
+ * @param[out] lost Number of records that were overwritten before they could be read.
+ * @return The number of records copied into @p records.
+ */
+static inline unsigned int telemetryHistoryRead(TELEMETRY_HISTORY *history, unsigned int *cursor,
+		TELEMETRY_RECORD *records, unsigned int max, unsigned int *lost) {
+	unsigned int head = __atomic_load_n(&history->head, __ATOMIC_ACQUIRE);
+	*lost = 0;
+	if (head - *cursor > TELEMETRY_HISTORY_SIZE) {
+		*lost = head - TELEMETRY_HISTORY_SIZE - *cursor;
+		*cursor = head - TELEMETRY_HISTORY_SIZE;
+	}
+	unsigned int count = head - *cursor;
+	if (count > max) {
+		count = max;
+	}
+	for (unsigned int index = 0; index < count; index++) {
+		records[index] = history->records[(*cursor + index) & (TELEMETRY_HISTORY_SIZE - 1)];
+	}
+	/* The writer may have lapped the oldest copied slots while we were copying */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	unsigned int after = __atomic_load_n(&history->head, __ATOMIC_RELAXED);
+	unsigned int overwritten = 0;
+	if (after - *cursor >= TELEMETRY_HISTORY_SIZE) {
+		overwritten = after - *cursor - TELEMETRY_HISTORY_SIZE + 1;
+		if (overwritten > count) {
+			overwritten = count;
+		}
+		memmove(records, records + overwritten, (count - overwritten) * sizeof(TELEMETRY_RECORD));
+	}
+	*lost += overwritten;
+	*cursor += count;
+	return count - overwritten;
+}
+
+#endif /* TELEMETRYHISTORY_H */
@@ -4,5 +4,5 @@
 
 USER_OBJS :=
 
-LIBS := -lrt -ll6470 -lbcm2835
+LIBS := -lrt -lpthread -ll6470 -lbcm2835
 
@@ -4,18 +4,36 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/Utilities/AllocationGuard.cpp \
 ../src/Utilities/Axis.cpp \
+../src/Utilities/ComponentProfiler.cpp \
+../src/Utilities/ComponentRegistry.cpp \
+../src/Utilities/ComponentScheduler.cpp \
 ../src/Utilities/ExampleComponent.cpp \
+../src/Utilities/MotionProfile.cpp \
+../src/Utilities/PositionSnapshot.cpp \
 ../src/Utilities/SharedMemory.cpp 
 
 OBJS += \
+./src/Utilities/AllocationGuard.o \
 ./src/Utilities/Axis.o \
+./src/Utilities/ComponentProfiler.o \
+./src/Utilities/ComponentRegistry.o \
+./src/Utilities/ComponentScheduler.o \
 ./src/Utilities/ExampleComponent.o \
+./src/Utilities/MotionProfile.o \
+./src/Utilities/PositionSnapshot.o \
 ./src/Utilities/SharedMemory.o 
 
 CPP_DEPS += \
+./src/Utilities/AllocationGuard.d \
 ./src/Utilities/Axis.d \
+./src/Utilities/ComponentProfiler.d \
+./src/Utilities/ComponentRegistry.d \
+./src/Utilities/ComponentScheduler.d \
 ./src/Utilities/ExampleComponent.d \
+./src/Utilities/MotionProfile.d \
+./src/Utilities/PositionSnapshot.d \
 ./src/Utilities/SharedMemory.d 
 
 
@@ -4,12 +4,21 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/Software/TargetGeneration/HighestPickOrder.cpp \
+../src/Software/TargetGeneration/NearestPickOrder.cpp \
+../src/Software/TargetGeneration/RasterPickOrder.cpp \
 ../src/Software/TargetGeneration/TargetGenerator.cpp 
 
 OBJS += \
+./src/Software/TargetGeneration/HighestPickOrder.o \
+./src/Software/TargetGeneration/NearestPickOrder.o \
+./src/Software/TargetGeneration/RasterPickOrder.o \
 ./src/Software/TargetGeneration/TargetGenerator.o 
 
 CPP_DEPS += \
+./src/Software/TargetGeneration/HighestPickOrder.d \
+./src/Software/TargetGeneration/NearestPickOrder.d \
+./src/Software/TargetGeneration/RasterPickOrder.d \
 ./src/Software/TargetGeneration/TargetGenerator.d 
 
 
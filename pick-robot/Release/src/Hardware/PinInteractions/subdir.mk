@@ -4,15 +4,27 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/Hardware/PinInteractions/HostMotorBus.cpp \
 ../src/Hardware/PinInteractions/I2C.cpp \
+../src/Hardware/PinInteractions/IoWorker.cpp \
+../src/Hardware/PinInteractions/MotorBus.cpp \
+../src/Hardware/PinInteractions/SpiMotorBus.cpp \
 ../src/Hardware/PinInteractions/StatusRegister.cpp 
 
 OBJS += \
+./src/Hardware/PinInteractions/HostMotorBus.o \
 ./src/Hardware/PinInteractions/I2C.o \
+./src/Hardware/PinInteractions/IoWorker.o \
+./src/Hardware/PinInteractions/MotorBus.o \
+./src/Hardware/PinInteractions/SpiMotorBus.o \
 ./src/Hardware/PinInteractions/StatusRegister.o 
 
 CPP_DEPS += \
+./src/Hardware/PinInteractions/HostMotorBus.d \
 ./src/Hardware/PinInteractions/I2C.d \
+./src/Hardware/PinInteractions/IoWorker.d \
+./src/Hardware/PinInteractions/MotorBus.d \
+./src/Hardware/PinInteractions/SpiMotorBus.d \
 ./src/Hardware/PinInteractions/StatusRegister.d 
 
 
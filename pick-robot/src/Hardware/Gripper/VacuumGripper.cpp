@@ -2,12 +2,24 @@
 
 #include <slushboard.h>
 
+#include "../PinInteractions/IoWorker.h"
+
 VacuumGripper::VacuumGripper(SlushBoard *slushboard) {
 	board = slushboard;
-	board->setIOState(SLUSH_IO_PORTA, SLUSH_IO_PIN0, 0);
+	IoWorker::getInstance()->setBoard(board);
+	setValve(0);
 	state = VC_OFF;
 }
 
+void VacuumGripper::setValve(uint8_t value) {
+	IO_REQUEST request = {};
+	request.operation = IO_BOARD_SET_IO;
+	request.slot = SLUSH_IO_PORTA;
+	request.parameter = SLUSH_IO_PIN0;
+	request.value = value;
+	IoWorker::getInstance()->push(&request);
+}
+
 VacuumGripper::~VacuumGripper() {
 
 }
@@ -21,7 +33,7 @@ void VacuumGripper::activate() {
 	case VC_OFF:
 		state = VC_ON;
 		vacuumSensor.beginReadingVacSensor();
-		board->setIOState(SLUSH_IO_PORTA, SLUSH_IO_PIN0, 1);
+		setValve(1);
 	}
 }
 
@@ -34,7 +46,7 @@ void VacuumGripper::deactivate() {
 	case VC_ON:
 		state = VC_OFF;
 		vacuumSensor.stopReadingVacSensor();
-		board->setIOState(SLUSH_IO_PORTA, SLUSH_IO_PIN0, 0);
+		setValve(0);
 	}
 }
 
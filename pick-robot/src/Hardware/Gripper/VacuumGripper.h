@@ -5,6 +5,9 @@
 #include "VacuumSensor.h"
 #include "../../Software/ErrorHandler/ErrorHandler.h"
 
+/** Worst case filtering of a conversion plus reportStatus, the I2C bus is the #IoWorker's, in microseconds */
+#define VACUUM_GRIPPER_COST_US 15
+
 class SlushBoard;
 
 /**
@@ -30,6 +33,13 @@ private:
 	 * @return The result of checking the suction value against the gripper state.
 	 */
 	bool vacuumSensorError();
+
+	/**
+	 * @fn setValve
+	 * @brief Queue switching the vacuum valve to the IoWorker.
+	 * @param[in] value 1 to open, 0 to close.
+	 */
+	void setValve(uint8_t value);
 public:
 	/**
 	 * @param[in] slushboard A pointer to the slushboard object.
@@ -63,6 +73,18 @@ public:
 		return &vacuumSensor;
 	}
 	void emergencyStop();
+
+	/**
+	 * @fn getPeriod
+	 * The #IoWorker reads the ADS1115 every poll, every tick, so each conversion is filtered on the next.
+	 */
+	unsigned int getPeriod() {
+		return 1;
+	}
+
+	unsigned int getStepCostUs() {
+		return VACUUM_GRIPPER_COST_US;
+	}
 };
 
 #endif /* SRC_HARDWARE_GRIPPER_VACUUMGRIPPER_H_ */
@@ -6,11 +6,16 @@
 #include <cstdint>
 #include <cstdio>
 
-#include "../PinInteractions/Registers.h"
+#include "../PinInteractions/IoWorker.h"
 
 void VacuumSensor::step(long long int clockTicks) {
 	if (this->activelyListening) {
-		this->filter.filterValue(this->getLastResult());
+		const IO_VACUUM_READING *reading = &IoWorker::getInstance()->getReadings()->vacuum;
+		// Filter each conversion read since our last start exactly once
+		if (reading->starts == this->starts && reading->samples != this->samples) {
+			this->samples = reading->samples;
+			this->filter.filterValue(this->getLastResult());
+		}
 	}
 }
 
@@ -62,6 +67,7 @@ void VacuumSensor::beginReadingVacSensor() {
 		this->resetVacSensor();
 		this->startReadComparator(this->channel + 0x04,ADS1x15_CONFIG_MODE_CONTINUOUS);
 		this->activelyListening = true;
+		this->samples = IoWorker::getInstance()->getReadings()->vacuum.samples;
 	}
 }
 
@@ -90,30 +96,29 @@ void VacuumSensor::startReadComparator(int mux, uint8_t mode) {
 
 	// Set number of comparator hits before alerting
 	config |= ads1115ConfigComparator[this->ADS_numOfReads];
-	// Send the config value to start the ADC conversion.
-	std::array<int, 2> configArray { {(config >> 8) & 0xFF, config & 0xFF} };
-	Registers::writeByte(ADS1x15_DEFAULT_ADDRESS, ADS1x15_POINTER_CONFIG, configArray);
-
-
 	/*
-	 * When writing new configuration settings, the currently ongoing conversion
-	 * completes with the previous configuration settings. Thereafter,
-	 * continuous conversions with the new configuration settings start.
-	 *
-	 * (ie. the first read value is from the previous config and should be ignored)
+	 * Send the config value to start the ADC conversion. The I/O worker discards
+	 * the first conversion, which completes with the previous configuration, then
+	 * keeps reading the conversion register.
 	 */
-	Registers::readByte(ADS1x15_DEFAULT_ADDRESS, ADS1x15_POINTER_CONVERSION);
+	IO_REQUEST request = {};
+	request.operation = IO_VACUUM_START;
+	request.value = config;
+	if (IoWorker::getInstance()->push(&request) != 0) {
+		this->starts++;
+	}
 }
 
 uint16_t VacuumSensor::getLastResult() {
-	std::array<uint8_t, 2> reg = Registers::readByte(ADS1x15_DEFAULT_ADDRESS, ADS1x15_POINTER_CONVERSION);
-	return this->convertValues(reg[1], reg[0]);
+	uint16_t conversion = IoWorker::getInstance()->getReadings()->vacuum.conversion;
+	return this->convertValues(conversion & 0xFF, conversion >> 8);
 }
 
 void VacuumSensor::stopReadingVacSensor() {
-	int config = ADS1x15_STOP_CONFIG;
-	std::array<int, 2> configArray { {(config >> 8) & 0xFF, config & 0xFF} };
-	Registers::writeByte(ADS1x15_DEFAULT_ADDRESS, ADS1x15_POINTER_CONFIG, configArray);
+	IO_REQUEST request = {};
+	request.operation = IO_VACUUM_STOP;
+	request.value = ADS1x15_STOP_CONFIG;
+	IoWorker::getInstance()->push(&request);
 	this->resetVacSensor();
 }
 
@@ -76,7 +76,7 @@ using namespace std;
  *  are then interpreted as suction values. Sensor operates by sampling continuously, when
  *  #activelyListening, or reports a arbitrarily high value greater than #highThresh. Sensor
  *  has the capability to change sampling rate, input voltage range, and differentiate between
- *  channels.
+ *  channels. The ADC is read by the IoWorker, #step filters each new conversion once.
  */
 class VacuumSensor: public VacSensorInterface {
 public:
@@ -101,6 +101,8 @@ public:
 			highThresh(HIGH_THRESH),
 			lowThresh(LOW_THRESH),
 			activelyListening(false),
+			starts(0),
+			samples(0),
 			ADS_numOfReads(ADS_numReads),
 			ads1115ConfigGain { // <-- Key: 0 is used in place of 2/3 (Value of 2/3 does not store neatly as a fraction)
 				{0,    	0x0000},
@@ -199,6 +201,8 @@ private:
 	int highThresh;				/**< The high threshold of read suction values (ie. values above are considered #BAD_SUCTION). */
 	int lowThresh;				/**< The low threshold of read suction values (ie. values below are considered #GOOD_SUCTION). */
 	bool activelyListening;		/**< Is the vacuum sensor reading values or ignoring them. */
+	unsigned int starts;		/**< Number of reads started through the IoWorker. */
+	unsigned int samples;		/**< The IO_VACUUM_READING::samples last filtered. */
 
 	// ADS1115 Chip
 	int ADS_numOfReads;
@@ -221,7 +225,7 @@ private:
 
 	/**
 	 * @fn getLastResult
-	 * @brief Read the last conversion result.
+	 * @brief The last conversion result read by the IoWorker.
 	 * @return A signed integer value representing the currently read suction.
 	 */
 	uint16_t getLastResult();
@@ -102,6 +102,12 @@ public:
 	 */
 	virtual int getPositionInSteps() = 0;
 
+	/**
+	 * @fn getSpeed
+	 * @return The current motor speed in steps per second, regardless of direction.
+	 */
+	virtual double getSpeed() = 0;
+
 	/**
 	 * @fn getPositionInMM
 	 * @return The current motor position in millimeters from the home location.
@@ -111,9 +117,28 @@ public:
 	/**
 	 * @fn zeroReturn
 	 * @brief Command the motor to zero return in a specific direction.
+	 *
+	 * The motor runs toward its limit switch and stops as soon as it is depressed,
+	 * 	a motor already on its switch doesn't move.
 	 * @param[in] dir The direction the motor should travel.
+	 * @param[in] stepsPerSec The speed to approach the switch at.
+	 */
+	virtual void zeroReturn(DIRECTION dir, double stepsPerSec) = 0;
+
+	/**
+	 * @fn backOffLimitSwitch
+	 * @brief Move the motor away from the limit switch it zero returns to in direction @p dir.
+	 * @param[in] dir The direction of the limit switch.
+	 * @param[in] steps The number of steps to move away.
+	 * @param[in] stepsPerSec The speed to move at.
+	 */
+	virtual void backOffLimitSwitch(DIRECTION dir, long steps, double stepsPerSec) = 0;
+
+	/**
+	 * @fn hasRetainedPosition
+	 * @return Whether the motor provably kept its position from before this process started.
 	 */
-	virtual void zeroReturn(DIRECTION dir) = 0;
+	virtual bool hasRetainedPosition() = 0;
 
 	/**
 	 * @fn setHome
@@ -159,6 +184,18 @@ public:
 	 */
 	virtual double getMaxSpeed() = 0;
 
+	/**
+	 * @fn getAcceleration
+	 * @return The acceleration of the motor in steps per second².
+	 */
+	virtual double getAcceleration() = 0;
+
+	/**
+	 * @fn getDeceleration
+	 * @return The deceleration of the motor in steps per second².
+	 */
+	virtual double getDeceleration() = 0;
+
 	/**
 	 * @fn mmToSteps
 	 * @param[in] desiredDist The desired distance the motor should move in millimeters.
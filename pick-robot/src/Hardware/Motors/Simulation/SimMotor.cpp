@@ -20,22 +20,34 @@ SimMotor::SimMotor(MOTOR_CONFIG *motorConfig)
 	  mmPerRev(motorConfig->mmPerRev),
 	  stepsPerRev(motorConfig->stepsPerRev),
 	  invert(motorConfig->invert ? -1 : 1),
-	  epsilon(0.5),
+	  accelStepsPerSec2(motorConfig->accelStepsPerSec2),
+	  decelStepsPerSec2(motorConfig->decelStepsPerSec2),
 	  motorAssignment(motorConfig->motorNumber),
 	  maxSpeed(maxStepsPerSec),
 	  minSpeed(MIN_STEPS_PER_SEC),
 	  home(0), // Arbitrary
 	  currentPosition(0), // Arbitrary
-	  targetPosition(0) // Arbitrary
-	{}
+	  targetPosition(0), // Arbitrary
+	  motionElapsed(0)
+	{
+		motion.configure(maxSpeed, accelStepsPerSec2, decelStepsPerSec2);
+	}
 
 void SimMotor::step(long long int clockTicks) {
 	if (isBusy()) {
-		float increment = std::min(this->stepsPerMs(), std::fabs(this->currentPosition - this->targetPosition));
-		this->currentPosition += increment * sign(this->targetPosition - this->currentPosition);
+		this->motionElapsed += 1.0 / SEC_TO_MILL;
+		this->currentPosition = this->motion.getPositionAt(this->motionElapsed);
 	}
 }
 
+void SimMotor::plan(double target) {
+	double speed = this->motion.getSpeedAt(this->motionElapsed);
+	this->motion.configure(this->maxSpeed, this->accelStepsPerSec2, this->decelStepsPerSec2);
+	this->motion.plan(this->currentPosition, speed, target);
+	this->motionElapsed = 0;
+	this->targetPosition = target;
+}
+
 void SimMotor::reportStatus(void *) {
 
 }
@@ -50,17 +62,17 @@ bool SimMotor::reachedTarget() {
 
 // Move in the direction based on the sign of the steps
 void SimMotor::move(long steps) {
-	this->targetPosition = this->currentPosition + steps;
+	this->plan(this->currentPosition + steps);
 }
 
 void SimMotor::goTo(axis_pos position) {
 	this->setSpeed(this->maxStepsPerSec);
-	this->targetPosition = position;
+	this->plan(position);
 }
 
 void SimMotor::goTo(axis_pos position, int stepsPerSec) {
 	this->setSpeed(stepsPerSec);
-	this->targetPosition = position;
+	this->plan(position);
 }
 
 int SimMotor::getPositionInSteps() {
@@ -71,21 +83,34 @@ axis_pos SimMotor::getPositionInMM() {
 	return (this->getMMPerRev() / this->getStepsPerRev()) * this->currentPosition;
 }
 
-void SimMotor::zeroReturn(DIRECTION dir) {
-	this->setHome();
+void SimMotor::zeroReturn(DIRECTION dir, double stepsPerSec) {
+	this->setSpeed(stepsPerSec);
+	this->plan(0);
+}
+
+void SimMotor::backOffLimitSwitch(DIRECTION dir, long steps, double stepsPerSec) {
+	this->setSpeed(stepsPerSec);
+	this->plan(this->currentPosition - labs(steps));
 }
 
 void SimMotor::setHome() {
+	this->hardStop();
 	this->currentPosition = 0;
+	this->targetPosition = 0;
 	this->home = this->currentPosition;
 }
 
 void SimMotor::hardStop() {
+	this->motion.plan(this->currentPosition, 0, this->currentPosition);
+	this->motionElapsed = 0;
 	this->targetPosition = this->currentPosition;
 }
 
 void SimMotor::softStop() {
-	this->targetPosition = this->currentPosition;
+	double speed = this->motion.getSpeedAt(this->motionElapsed);
+	this->motion.planStop(this->currentPosition, speed);
+	this->motionElapsed = 0;
+	this->targetPosition = this->motion.getTarget();
 }
 
 void SimMotor::updateConfig(MOTOR_CONFIG * motorConfig) {
@@ -94,6 +119,8 @@ void SimMotor::updateConfig(MOTOR_CONFIG * motorConfig) {
 	this->mmPerRev = motorConfig->mmPerRev;
 	this->stepsPerRev = motorConfig->stepsPerRev;
 	this->maxSpeed = this->maxStepsPerSec;
+	this->accelStepsPerSec2 = motorConfig->accelStepsPerSec2;
+	this->decelStepsPerSec2 = motorConfig->decelStepsPerSec2;
 }
 
 double SimMotor::mmToSteps(long desiredDist) {
@@ -101,7 +128,9 @@ double SimMotor::mmToSteps(long desiredDist) {
 }
 
 void SimMotor::goToHome() {
+	this->hardStop();
 	this->currentPosition = 0;
+	this->targetPosition = 0;
 }
 
 // Intentionally left blank
@@ -118,12 +147,7 @@ bool SimMotor::isLimitSwitchDepressed() {
 }
 
 bool SimMotor::isBusy() {
-	return this->currentPosition >= this->targetPosition + this->epsilon ||
-			this->currentPosition <= this->targetPosition - this->epsilon;
-}
-
-float SimMotor::stepsPerMs() {
-	return (float) this->maxSpeed / 1000.0;
+	return this->motionElapsed < this->motion.getDuration();
 }
 
 void SimMotor::setSpeed(double speed) {
@@ -6,10 +6,12 @@
  */
 #include <stdio.h>
 #include <math.h>
+#include <stdlib.h>
 #include <algorithm>
 #include <ConfigStruct.h>
 
 #include "../MotorInterface.h"
+#include "../../../Utilities/MotionProfile.h"
 
 #ifndef SRC_HARDWARE_MOTORS_SIMULATEDMOTOR_H_
 #define SRC_HARDWARE_MOTORS_SIMULATEDMOTOR_H_
@@ -20,6 +22,7 @@
  *
  * Does not establish physical interactions with hardware, but exists
  * 	as a way to test the logic of the Pick-Robot stepper motor software.
+ * 	Moves follow the same trapezoidal #MotionProfile as the L6470, one millisecond per tick.
  */
 class SimMotor : public MotorInterface {
 public:
@@ -31,7 +34,7 @@ public:
 
 	/**
 	 * @fn step
-	 * Increment the motor in the appropriate direction till it has reached the
+	 * Advance the motor one millisecond along its #motion till it has reached the
 	 * 	desired #targetPosition.
 	 */
 	void step(long long int clockTicks);
@@ -56,14 +59,33 @@ public:
 		return mmPerRev;
 	}
 	int getPositionInSteps();
+	double getSpeed() {
+		return std::fabs(motion.getSpeedAt(motionElapsed));
+	}
 	int getPositionInMM();
 
 	/**
 	 * @fn zeroReturn
-	 * @brief Functions instantaneously by setting #home to 0.
+	 * @brief Simulates approaching the limit switch, which sits at 0.
+	 * @param[in] dir Unused directional value.
+	 * @param[in] stepsPerSec The speed to approach at.
+	 */
+	void zeroReturn(DIRECTION dir, double stepsPerSec);
+
+	/**
+	 * @fn backOffLimitSwitch
+	 * @brief Simulates moving @p steps away from the limit switch, into the negative axis.
 	 * @param[in] dir Unused directional value.
 	 */
-	void zeroReturn(DIRECTION dir);
+	void backOffLimitSwitch(DIRECTION dir, long steps, double stepsPerSec);
+
+	/**
+	 * @fn hasRetainedPosition
+	 * @return `false`, simulated positions start over with the process.
+	 */
+	bool hasRetainedPosition() {
+		return false;
+	}
 
 	/**
 	 * @fn setHome
@@ -79,7 +101,7 @@ public:
 
 	/**
 	 * @fn softStop
-	 * @brief Simulates immediate deceleration and stop by setting #targetPosition to #currentPosition.
+	 * @brief Simulates deceleration to a stop, #targetPosition is where the motor comes to rest.
 	 */
 	void softStop();
 	int getStepsPerRev() {
@@ -90,6 +112,12 @@ public:
 	double getMaxSpeed() {
 		return maxStepsPerSec;
 	}
+	double getAcceleration() {
+		return accelStepsPerSec2;
+	}
+	double getDeceleration() {
+		return decelStepsPerSec2;
+	}
 	double mmToSteps(long desiredDist);
 
 	/**
@@ -110,27 +138,29 @@ private:
 	double mmPerRev;			/**< The required number of millimeters to travel before completing a full motor revolution. */
 	long stepsPerRev;			/**< The required number of steps to take before completing a full revolution. */
 	int invert;					/**< Flag that determines if motor motions are reversed. */
-	int epsilon;				/**< The acceptable margin of error in millimeters. */
+	int accelStepsPerSec2;		/**< The acceleration in steps/second². */
+	int decelStepsPerSec2;		/**< The deceleration in steps/second². */
 
 	int motorAssignment;		/**< The motor ID. */
 	double maxSpeed;			/**< The max speed of the motor in steps/second. */
 	double minSpeed;			/**< The min speed of the motor in steps/second. */
 	int home;					/**< The home location of the motor in millimeters. */
-	float currentPosition;		/**< The current position of the motor in millimeters. */
-	float targetPosition;		/**< The target position of the motor in millimeters. */
+	float currentPosition;		/**< The current position of the motor in steps. */
+	float targetPosition;		/**< The target position of the motor in steps. */
+	MotionProfile motion;		/**< The move to #targetPosition. */
+	double motionElapsed;		/**< Seconds since #motion started. */
 
 	/**
 	 * @fn isBusy
-	 * @return Checks that the #currentPosition is close to the #targetPosition within some
-	 * 	reasonable margin of error #epsilon.
+	 * @return Whether #motion has not finished yet.
 	 */
 	bool isBusy();
 
 	/**
-	 * @fn stepsPerMs
-	 * @return Dynamically calculate the steps-per-second based on the current max speed.
+	 * @fn plan
+	 * @brief Start a move to @p target from the current position and speed.
 	 */
-	float stepsPerMs();
+	void plan(double target);
 };
 
 #endif /* SRC_HARDWARE_MOTORS_SIMULATEDMOTOR_H_ */
@@ -5,20 +5,59 @@
 #include <slushmotor.h>
 #include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+
+#include "../PinInteractions/IoWorker.h"
 
 StepperMotor::StepperMotor(MOTOR_CONFIG * motorConfig) {
 	this->maxStepsPerSec = motorConfig->maxStepsPerSec;
+	this->accelStepsPerSec2 = motorConfig->accelStepsPerSec2;
+	this->decelStepsPerSec2 = motorConfig->decelStepsPerSec2;
 	this->invert = motorConfig->invert ? -1 : 1;
 	this->mmPerRev = motorConfig->mmPerRev;
 	this->stepsPerRev = motorConfig->stepsPerRev;
 	this->motor = new SlushMotor(motorConfig->motorNumber);
-	this->motor->resetDev();
-	this->motor->setCurrent(motorConfig->holdCurrent, motorConfig->runCurrent, motorConfig->accelCurrent,
-			motorConfig->decelCurrent);
-	this->motor->setMaxSpeed(maxStepsPerSec);
-	this->motor->setFullSpeed(1500);
-	this->motor->setMinSpeed(MIN_STEPS_PER_SEC);
 	this->statusRegister = StatusRegister();
+	this->slot = IoWorker::getInstance()->addMotor(this->motor);
+	this->lastRequest = 0;
+	this->statusSequence = 0;
+	// Set up through the worker so every bus transaction is counted
+	this->request(IO_MOTOR_READ_STATE);
+	uint16_t status = this->reading()->status;
+	// UVLO is latched low by power-up and resets, HiZ is set until the bridges first drive the motor
+	this->retained = this->slot >= 0 && (status & L6470_STATUS_UVLO) && !(status & L6470_STATUS_HIZ)
+			&& (status & L6470_STATUS_BUSY);
+	if (!this->retained) {
+		this->request(IO_MOTOR_RESET, 1500);
+	}
+	this->updateConfig(motorConfig);
+}
+
+const IO_MOTOR_READING *StepperMotor::reading() {
+	static const IO_MOTOR_READING none = {};
+	return this->slot < 0 ? &none : &IoWorker::getInstance()->getReadings()->motors[this->slot];
+}
+
+void StepperMotor::request(IO_OPERATION operation, long value, float maxSpeed, float minSpeed) {
+	IO_REQUEST request = {};
+	request.operation = operation;
+	request.slot = this->slot;
+	request.value = value;
+	request.maxSpeed = maxSpeed;
+	request.minSpeed = minSpeed;
+	this->push(&request);
+}
+
+void StepperMotor::push(IO_REQUEST *request) {
+	// A dropped request raises an #EL_STOP error, which stops the axes before anything waits on it
+	unsigned int sequence = IoWorker::getInstance()->push(request);
+	if (sequence != 0) {
+		this->lastRequest = sequence;
+	}
+}
+
+float StepperMotor::clampSpeed(double speed) {
+	return std::abs(std::max(1.0, std::min(speed, (double) maxStepsPerSec)));
 }
 
 StepperMotor::~StepperMotor() {
@@ -26,8 +65,13 @@ StepperMotor::~StepperMotor() {
 }
 
 void StepperMotor::step(long long int clockTicks) {
-	// Caution: checking the flags set by the STATUS register resets the warning/error flags
-	this->statusRegister.updateStatus(this->motor);
+	// The I/O worker reads the STATUS register (which resets the warning/error flags), decode each read once
+	const IO_MOTOR_READING *reading = this->reading();
+	if (reading->statusSequence == this->statusSequence) {
+		return;
+	}
+	this->statusSequence = reading->statusSequence;
+	this->statusRegister.updateStatus(reading->status);
 	std::array<ERROR_LEVEL, STATUS_REG_FLAGS> *errorStatus = this->statusRegister.getErrorStatus();
 	if (this->statusRegister.getNumberOfErrors()) {
 		for (unsigned int status = 0; status < errorStatus->size(); status++) {
@@ -53,73 +97,76 @@ void StepperMotor::reportStatus(void *robotOutPtr) {
 }
 
 void StepperMotor::emergencyStop() {
-	this->motor->hardStop();
+	IoWorker::getInstance()->emergencyStop();
 }
 
 bool StepperMotor::reachedTarget() {
+	// Until the worker has polled after our last request, the reading predates it
+	if ((int) (IoWorker::getInstance()->getReadings()->requestsDone - this->lastRequest) < 0) {
+		return false;
+	}
 	// If motor is busy, has not reached target
-	return !this->motor->isBusy();
+	return !this->reading()->busy;
 }
 
 bool StepperMotor::isLimitSwitchDepressed() {
-	return !(this->motor->getStatus() & L6470_STATUS_SW_F);
+	return !(this->reading()->status & L6470_STATUS_SW_F);
 }
 
 void StepperMotor::hardStop() {
-	this->motor->hardStop();
+	this->request(IO_MOTOR_HARD_STOP);
 }
 
 void StepperMotor::softStop() {
-	this->motor->softStop();
+	this->request(IO_MOTOR_SOFT_STOP);
 }
 
 void StepperMotor::move(long steps) {
-	this->motor->move(this->stepsToMicroSteps(steps));
+	this->request(IO_MOTOR_MOVE, this->stepsToMicroSteps(steps));
 }
 
 void StepperMotor::goTo(axis_pos position) {
-	setSpeed(maxStepsPerSec);
-	this->motor->goTo((int) this->stepsToMicroSteps(position));
+	this->request(IO_MOTOR_GO_TO, this->stepsToMicroSteps(position), clampSpeed(maxStepsPerSec), MAGIC_MIN_SPEED);
 }
 
 void StepperMotor::goTo(axis_pos position, int stepsPerSec) {
-	setSpeed(stepsPerSec);
-	this->motor->goTo((int) this->stepsToMicroSteps(position));
+	this->request(IO_MOTOR_GO_TO, this->stepsToMicroSteps(position), clampSpeed(stepsPerSec), MAGIC_MIN_SPEED);
 }
 
 void StepperMotor::setSpeed(double speed) {
-	float speedToSet = std::max(1.0, std::min(speed, (double) maxStepsPerSec));
-	this->motor->setMaxSpeed(std::abs(speedToSet));
-	this->motor->setMinSpeed(MAGIC_MIN_SPEED);
-}
-
-
-void StepperMotor::zeroReturn(DIRECTION dir) {
-	this->motor->setMaxSpeed(400.0);
-	this->motor->setMinSpeed(200.0);
-	if (StepperMotor::isLimitSwitchDepressed()) {
-		this->motor->setAsHome();
-	} else {
-		switch (dir) {
-			case DIRECTION::DIR_FORWARD:
-				this->motor->releaseSw(L6470_ABSPOS_RESET, L6470_DIR_FWD);
-				break;
-			case DIRECTION::DIR_BACKWARD:
-				this->motor->releaseSw(L6470_ABSPOS_RESET, L6470_DIR_REV);
-				break;
-			default:
-				perror("Bad directional value in StepperMotor::zeroReturn()");
-				break;
-		}
+	this->request(IO_MOTOR_SET_SPEED, 0, clampSpeed(speed), MAGIC_MIN_SPEED);
+}
+
+
+void StepperMotor::zeroReturn(DIRECTION dir, double stepsPerSec) {
+	// The worker checks the limit switch before releasing it, at the minimum speed
+	float speed = clampSpeed(stepsPerSec);
+	switch (dir) {
+		case DIRECTION::DIR_FORWARD:
+			this->request(IO_MOTOR_ZERO_RETURN, 1, clampSpeed(2 * speed), speed);
+			break;
+		case DIRECTION::DIR_BACKWARD:
+			this->request(IO_MOTOR_ZERO_RETURN, -1, clampSpeed(2 * speed), speed);
+			break;
+		default:
+			perror("Bad directional value in StepperMotor::zeroReturn()");
+			break;
 	}
 }
 
+void StepperMotor::backOffLimitSwitch(DIRECTION dir, long steps, double stepsPerSec) {
+	// Zero returns aren't inverted, neither is backing off
+	long microSteps = std::abs(this->stepsToMicroSteps(steps));
+	this->request(IO_MOTOR_MOVE, dir == DIRECTION::DIR_FORWARD ? -microSteps : microSteps, clampSpeed(stepsPerSec),
+			MAGIC_MIN_SPEED);
+}
+
 void StepperMotor::setHome() {
-	this->motor->setAsHome();
+	this->request(IO_MOTOR_SET_HOME);
 }
 
 int StepperMotor::getPositionInSteps() {
-	return this->motor->getPos();
+	return this->reading()->position;
 }
 
 int StepperMotor::stepsToMicroSteps(int steps) {
@@ -137,11 +184,16 @@ int StepperMotor::microstepsToSteps(int microsteps) {
 }
 
 void StepperMotor::setSteppingMode(STEP_STYLE mode) {
-	this->motor->setParam(L6470_PARAM_STEP_MODE, (unsigned long) mode);
+	IO_REQUEST request = {};
+	request.operation = IO_MOTOR_SET_PARAM;
+	request.slot = this->slot;
+	request.parameter = L6470_PARAM_STEP_MODE;
+	request.value = mode;
+	this->push(&request);
 }
 
 axis_pos StepperMotor::getPositionInMM() {
-	return round((this->getMMPerRev() / this->getStepsPerRev()) * microstepsToSteps(this->motor->getPos()));
+	return round((this->getMMPerRev() / this->getStepsPerRev()) * microstepsToSteps(this->reading()->position));
 }
 
 void StepperMotor::updateConfig(MOTOR_CONFIG * motorConfig) {
@@ -149,9 +201,24 @@ void StepperMotor::updateConfig(MOTOR_CONFIG * motorConfig) {
 	this->maxStepsPerSec = motorConfig->maxStepsPerSec;
 	this->mmPerRev = motorConfig->mmPerRev;
 	this->stepsPerRev = motorConfig->stepsPerRev;
-	this->motor->setCurrent(motorConfig->holdCurrent, motorConfig->runCurrent, motorConfig->accelCurrent,
-			motorConfig->decelCurrent);
-	this->motor->setMaxSpeed(maxStepsPerSec);
+	IO_REQUEST request = {};
+	request.operation = IO_MOTOR_SET_CURRENT;
+	request.slot = this->slot;
+	request.current[0] = motorConfig->holdCurrent;
+	request.current[1] = motorConfig->runCurrent;
+	request.current[2] = motorConfig->accelCurrent;
+	request.current[3] = motorConfig->decelCurrent;
+	request.maxSpeed = maxStepsPerSec;
+	request.minSpeed = MIN_STEPS_PER_SEC;
+	this->push(&request);
+	this->accelStepsPerSec2 = motorConfig->accelStepsPerSec2;
+	this->decelStepsPerSec2 = motorConfig->decelStepsPerSec2;
+	request = {};
+	request.operation = IO_MOTOR_SET_ACCEL;
+	request.slot = this->slot;
+	request.value = accelStepsPerSec2;
+	request.parameter = decelStepsPerSec2;
+	this->push(&request);
 }
 
 double StepperMotor::getMaxSpeed() {
@@ -163,13 +230,11 @@ double StepperMotor::mmToSteps(long desiredDist) {
 }
 
 void StepperMotor::goToHome() {
-	motor->goHome();
+	this->request(IO_MOTOR_GO_HOME);
 }
 
 void StepperMotor::moveOffOfLimitSwitches(long steps) {
-	this->motor->setMaxSpeed(100);
-	this->motor->setMinSpeed(50);
-	this->motor->move(this->stepsToMicroSteps(steps));
+	this->request(IO_MOTOR_MOVE, this->stepsToMicroSteps(steps), 100, 50);
 }
 
 DIRECTION StepperMotor::invertDirection(DIRECTION dir) {
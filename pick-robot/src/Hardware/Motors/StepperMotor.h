@@ -5,9 +5,13 @@
 #include <SharedMemoryStructs.h>
 
 #include "MotorInterface.h"
+#include "../PinInteractions/IoWorker.h"
 #include "../PinInteractions/StatusRegister.h"
 #include "../../Software/ErrorHandler/ErrorHandler.h"
 
+/** Worst case decode of a STATUS snapshot plus reportStatus, the bus is the #IoWorker's, in microseconds */
+#define STEPPER_STATUS_COST_US 15
+
 class SlushMotor;
 
 /**
@@ -21,6 +25,9 @@ class SlushMotor;
  *  to a set home location, all while handling errors that may occur, in realtime. Direction motor communication
  *  is processed using the L6470 microstepping motor controller, specific to each motor on the
  *  SlushBoard.
+ *
+ * Once the #IoWorker is started commands are queued to it and positions, busy and status
+ *  come from its last poll, so no call blocks on the SPI bus.
  */
 class StepperMotor : public MotorInterface {
 public:
@@ -54,6 +61,18 @@ public:
 	 */
 	void emergencyStop();
 
+	/**
+	 * @fn getPeriod
+	 * The #IoWorker reads STATUS every #IO_STATUS_POLL_PERIOD polls, stepping more often finds nothing new.
+	 */
+	unsigned int getPeriod() {
+		return IO_STATUS_POLL_PERIOD;
+	}
+
+	unsigned int getStepCostUs() {
+		return STEPPER_STATUS_COST_US;
+	}
+
     bool reachedTarget();
     void move(long steps);
 	void goTo(axis_pos position);
@@ -62,7 +81,21 @@ public:
 		return mmPerRev;
 	}
 	int getPositionInSteps();
-	void zeroReturn(DIRECTION dir);
+	double getSpeed() {
+		return this->reading()->speed;
+	}
+	void zeroReturn(DIRECTION dir, double stepsPerSec);
+	void backOffLimitSwitch(DIRECTION dir, long steps, double stepsPerSec);
+
+	/**
+	 * @fn hasRetainedPosition
+	 * @return Whether, when constructed, the driver was stopped and had neither lost power
+	 * 	nor released the motor since it was last set up, so its position still holds and
+	 * 	it was not reset.
+	 */
+	bool hasRetainedPosition() {
+		return retained;
+	}
     void setHome();
 	void hardStop();
 	void softStop();
@@ -73,6 +106,12 @@ public:
 	void updateConfig(MOTOR_CONFIG * motorConfig);
 	void setSpeed(double speed);
 	double getMaxSpeed();
+	double getAcceleration() {
+		return accelStepsPerSec2;
+	}
+	double getDeceleration() {
+		return decelStepsPerSec2;
+	}
 	double mmToSteps(long desiredDist);
 	void goToHome();
 	void moveOffOfLimitSwitches(long steps);
@@ -116,11 +155,41 @@ public:
 
 private:
 	int maxStepsPerSec;				/**< The designated maximum steps/second the motor can travel. */
+	int accelStepsPerSec2;			/**< The acceleration set on the driver, steps/second². */
+	int decelStepsPerSec2;			/**< The deceleration set on the driver, steps/second². */
 	SlushMotor* motor;				/**< A reference to the SlushMotor.h library */
 	double mmPerRev;				/**< The required number of millimeters to travel before completing a full motor revolution. */
     long stepsPerRev;				/**< The required number of steps to take before completing a full revolution. */
     int invert;						/**< Flag that determines if motor motions are reversed. */
     StatusRegister statusRegister;	/**< The status of the current motor as reported from SlushBoard.h */
+    int slot;						/**< The motor's slot in the #IoWorker */
+    unsigned int lastRequest;		/**< Sequence of the last request queued to the #IoWorker */
+    bool retained;					/**< See #hasRetainedPosition */
+    unsigned int statusSequence;	/**< The IO_MOTOR_READING::statusSequence last decoded */
+
+    /**
+     * @fn reading
+     * @return The motor's readings from the #IoWorker's last poll.
+     */
+    const IO_MOTOR_READING *reading();
+
+    /**
+     * @fn request
+     * @brief Queue a request for this motor to the #IoWorker.
+     */
+    void request(IO_OPERATION operation, long value = 0, float maxSpeed = 0, float minSpeed = 0);
+
+    /**
+     * @fn push
+     * @brief Queue a request to the #IoWorker and remember its sequence.
+     */
+    void push(IO_REQUEST *request);
+
+    /**
+     * @fn clampSpeed
+     * @return @p speed limited to [1, #maxStepsPerSec] steps/second.
+     */
+    float clampSpeed(double speed);
 };
 
 
@@ -0,0 +1,171 @@
+#include "HostMotorBus.h"
+
+#include <l6470constants.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include "IoWorker.h"
+
+/** Microsteps per step, the reset STEP_MODE */
+#define HOST_MICROSTEPS 128
+/** Steps/second per MAX_SPEED unit */
+#define HOST_MAX_SPEED_UNIT (1 / .065536)
+/** Steps/second² per ACC and DEC unit */
+#define HOST_ACCELERATION_UNIT 14.55
+/** STATUS with every active low flag inactive */
+#define HOST_STATUS_IDLE (L6470_STATUS_UVLO | L6470_STATUS_TH_WRN | L6470_STATUS_TH_SD | L6470_STATUS_OCD \
+		| L6470_STATUS_STEP_LOSS_A | L6470_STATUS_STEP_LOSS_B)
+
+HostMotorBus::HostMotorBus() {
+	for (int slot = 0; slot < MOTOR_BUS_MAX_DRIVERS; slot++) {
+		DRIVER *driver = &drivers[slot];
+		memset(driver->registers, 0, sizeof(driver->registers));
+		// Datasheet reset values of the registers moves depend on
+		driver->registers[L6470_PARAM_ACC] = 0x08A;
+		driver->registers[L6470_PARAM_DECEL] = 0x08A;
+		driver->registers[L6470_PARAM_MAX_SPEED] = 0x041;
+		driver->registers[L6470_PARAM_STEP_MODE] = 0x07;
+		driver->started = 0;
+		driver->origin = 0;
+		driver->command = L6470_CMD_NOP;
+		driver->remaining = 0;
+		driver->argument = 0;
+		driver->reply = 0;
+		driver->highImpedance = true;
+		driver->stalled = false;
+	}
+}
+
+double HostMotorBus::now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+double HostMotorBus::getPosition(DRIVER *driver, double at) {
+	return driver->motion.getPositionAt(at - driver->started);
+}
+
+double HostMotorBus::getSpeed(DRIVER *driver, double at) {
+	return driver->motion.getSpeedAt(at - driver->started);
+}
+
+unsigned long HostMotorBus::getStatus(DRIVER *driver, double at) {
+	double elapsed = at - driver->started;
+	unsigned long status = HOST_STATUS_IDLE;
+	if (driver->highImpedance) {
+		status |= L6470_STATUS_HIZ;
+	}
+	if (elapsed >= driver->motion.getDuration() && !driver->stalled) {
+		return status | L6470_STATUS_BUSY;
+	}
+	double speed = fabs(driver->motion.getSpeedAt(elapsed));
+	double later = fabs(driver->motion.getSpeedAt(elapsed + 0.001));
+	// MOT_STATUS: 1 accelerating, 2 decelerating, 3 constant speed
+	status |= (later > speed ? 1 : later < speed ? 2 : 3) << 5;
+	if (driver->motion.getTarget() > getPosition(driver, at)) {
+		status |= L6470_STATUS_DIR;
+	}
+	return status;
+}
+
+unsigned long HostMotorBus::getParam(DRIVER *driver, TL6470ParamRegisters param, double at) {
+	switch (param) {
+	case L6470_PARAM_ABS_POS:
+		return (long) round(getPosition(driver, at) - driver->origin) & 0x3FFFFF;
+	case L6470_PARAM_SPEED:
+		return (unsigned long) (fabs(getSpeed(driver, at)) / HOST_MICROSTEPS * IO_SPEED_UNITS_PER_STEP_PER_SEC) & 0xFFFFF;
+	case L6470_PARAM_STATUS:
+		return getStatus(driver, at);
+	default:
+		return param <= L6470_PARAM_STATUS ? driver->registers[param] : 0;
+	}
+}
+
+void HostMotorBus::plan(DRIVER *driver, double target, double at) {
+	double position = getPosition(driver, at);
+	double speed = getSpeed(driver, at);
+	driver->motion.configure(driver->registers[L6470_PARAM_MAX_SPEED] * HOST_MAX_SPEED_UNIT * HOST_MICROSTEPS,
+			driver->registers[L6470_PARAM_ACC] * HOST_ACCELERATION_UNIT * HOST_MICROSTEPS,
+			driver->registers[L6470_PARAM_DECEL] * HOST_ACCELERATION_UNIT * HOST_MICROSTEPS);
+	driver->motion.plan(position, speed, target);
+	driver->started = at;
+	driver->stalled = false;
+	if (driver->registers[L6470_PARAM_MAX_SPEED] == 0 && round(target) != round(position)) {
+		driver->motion.plan(position, 0, position);
+		driver->stalled = true;
+	}
+}
+
+void HostMotorBus::begin(DRIVER *driver, uint8_t command, double at) {
+	driver->command = command;
+	driver->argument = 0;
+	driver->reply = 0;
+	driver->remaining = 0;
+	if (command == L6470_CMD_GOTO) {
+		driver->remaining = 3;
+	} else if (command == L6470_CMD_GET_STATUS) {
+		driver->reply = getStatus(driver, at);
+		driver->remaining = 2;
+	} else if ((command & 0xE0) == L6470_CMD_GET_PARAM) {
+		TL6470ParamRegisters param = (TL6470ParamRegisters) (command & 0x1F);
+		driver->reply = getParam(driver, param, at);
+		driver->remaining = getParamLength(param);
+	} else if ((command & 0xE0) == L6470_CMD_SET_PARAM && command != L6470_CMD_NOP) {
+		driver->remaining = getParamLength((TL6470ParamRegisters) (command & 0x1F));
+	}
+	if (driver->remaining == 0) {
+		execute(driver, at);
+	}
+}
+
+void HostMotorBus::execute(DRIVER *driver, double at) {
+	uint8_t command = driver->command;
+	if (command == L6470_CMD_GOTO) {
+		plan(driver, driver->origin + MotorBus::toPosition(driver->argument), at);
+		driver->highImpedance = false;
+	} else if (command == L6470_CMD_SOFT_STOP) {
+		double position = getPosition(driver, at);
+		double speed = getSpeed(driver, at);
+		driver->motion.planStop(position, speed);
+		driver->started = at;
+		driver->stalled = false;
+	} else if (command == L6470_CMD_HARD_STOP) {
+		double position = getPosition(driver, at);
+		driver->motion.plan(position, 0, position);
+		driver->started = at;
+		driver->stalled = false;
+	} else if (command == L6470_CMD_RESET_POS) {
+		driver->origin = round(getPosition(driver, at));
+	} else if ((command & 0xE0) == L6470_CMD_SET_PARAM && command != L6470_CMD_NOP
+			&& (command & 0x1F) <= L6470_PARAM_STATUS) {
+		driver->registers[command & 0x1F] = driver->argument;
+	}
+	driver->command = L6470_CMD_NOP;
+}
+
+uint8_t HostMotorBus::exchange(DRIVER *driver, uint8_t byte, double at) {
+	if (driver->remaining == 0) {
+		begin(driver, byte, at);
+		return 0;
+	}
+	driver->remaining--;
+	uint8_t reply = (driver->reply >> (8 * driver->remaining)) & 0xFF;
+	driver->argument = (driver->argument << 8) | byte;
+	if (driver->remaining == 0) {
+		execute(driver, at);
+	}
+	return reply;
+}
+
+void HostMotorBus::transfer(MOTOR_BUS_FRAMES frames, int length, unsigned int slots) {
+	double at = now();
+	for (int byte = 0; byte < length; byte++) {
+		for (int slot = 0; slot < MOTOR_BUS_MAX_DRIVERS; slot++) {
+			if (slots & (1u << slot)) {
+				frames[byte][slot] = exchange(&drivers[slot], frames[byte][slot], at);
+			}
+		}
+	}
+}
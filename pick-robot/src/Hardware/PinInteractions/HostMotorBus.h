@@ -0,0 +1,64 @@
+#ifndef SRC_HARDWARE_PININTERACTIONS_HOSTMOTORBUS_H_
+#define SRC_HARDWARE_PININTERACTIONS_HOSTMOTORBUS_H_
+
+/**
+ * @file HostMotorBus.h
+ */
+
+#include "MotorBus.h"
+#include "../../Utilities/MotionProfile.h"
+
+/**
+ * @class HostMotorBus
+ * @brief A stand-in for the SlushEngine's SPI bus, so LOCAL builds run the #IoWorker without hardware.
+ *
+ * Each driver decodes the L6470 commands #MotorBus sends: GET_PARAM, SET_PARAM,
+ * 	GET_STATUS, GOTO, SOFT_STOP, HARD_STOP and RESET_POS. Moves follow the
+ * 	MAX_SPEED, ACC and DEC registers on a #MotionProfile against the monotonic
+ * 	clock, so ABS_POS, SPEED and the BUSY flag change as they would on the board.
+ * 	A GOTO with MAX_SPEED 0 never moves and never completes.
+ * 	Like a freshly powered driver, STATUS reports HiZ until the first move.
+ * 	Commands libl6470 sends directly never reach it.
+ */
+class HostMotorBus : public MotorBus {
+private:
+	/** One emulated L6470 */
+	typedef struct {
+		unsigned long registers[L6470_PARAM_STATUS + 1];	/**< Written by SET_PARAM */
+		MotionProfile motion;								/**< The move in microsteps */
+		double started;										/**< Seconds on the monotonic clock the move started */
+		double origin;										/**< Microstep position ABS_POS counts from */
+		uint8_t command;									/**< The command being received or answered */
+		int remaining;										/**< Bytes of the command still to come */
+		unsigned long argument;								/**< Argument received so far */
+		unsigned long reply;								/**< Reply being sent */
+		bool highImpedance;									/**< The bridges are off, until the first move */
+		bool stalled;										/**< Sent somewhere with MAX_SPEED 0, busy until stopped */
+	} DRIVER;
+
+	/** The drivers, indexed by slot */
+	DRIVER drivers[MOTOR_BUS_MAX_DRIVERS];
+
+	double now();
+	double getPosition(DRIVER *driver, double at);
+	double getSpeed(DRIVER *driver, double at);
+	unsigned long getStatus(DRIVER *driver, double at);
+	unsigned long getParam(DRIVER *driver, TL6470ParamRegisters param, double at);
+	void plan(DRIVER *driver, double target, double at);
+	void begin(DRIVER *driver, uint8_t command, double at);
+	void execute(DRIVER *driver, double at);
+	uint8_t exchange(DRIVER *driver, uint8_t byte, double at);
+
+public:
+	/**
+	 * Sets every driver to its power-up state: stopped at 0, reset register values, HiZ.
+	 */
+	HostMotorBus();
+	virtual ~HostMotorBus() {}
+
+	void attach(int, int) {
+	}
+	void transfer(MOTOR_BUS_FRAMES frames, int length, unsigned int slots);
+};
+
+#endif /* SRC_HARDWARE_PININTERACTIONS_HOSTMOTORBUS_H_ */
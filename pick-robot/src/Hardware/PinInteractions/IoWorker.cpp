@@ -0,0 +1,458 @@
+#include "IoWorker.h"
+
+#include <l6470.h>
+#include <l6470constants.h>
+#include <sched.h>
+#include <slushboard.h>
+#include <slushmotor.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <array>
+
+#include "HostMotorBus.h"
+#include "Registers.h"
+#include "SpiMotorBus.h"
+#include "../Gripper/VacuumSensor.h"
+#include "../../Software/ErrorHandler/ErrorHandler.h"
+
+IoWorker::IoWorker() {
+	memset(motors, 0, sizeof(motors));
+	numberOfMotors = 0;
+	for (int slot = 0; slot < IO_MAX_MOTORS; slot++) {
+		positionStale[slot] = true;
+	}
+	board = NULL;
+#ifdef LOCAL
+	bus = new HostMotorBus();
+#else
+	bus = new SpiMotorBus();
+#endif
+	staged = 0;
+	stagedAt = 0;
+	memset(stagedRequests, 0, sizeof(stagedRequests));
+	memset(requests, 0, sizeof(requests));
+	head = 0;
+	tail = 0;
+	dropped = 0;
+	memset(&wake, 0, sizeof(SHARED_EVENT));
+	stopPending = false;
+	stopAt = 0;
+	dropBefore = 0;
+	holding = false;
+	held = 0;
+	memset(buffers, 0, sizeof(buffers));
+	latest = 0;
+	memset(&polling, 0, sizeof(IO_READINGS));
+	memset(&sampled, 0, sizeof(IO_READINGS));
+	vacuumListening = false;
+	polls = 0;
+	transactions = 0;
+	running = false;
+}
+
+IoWorker::~IoWorker() {
+	if (running) {
+		__atomic_store_n(&running, false, __ATOMIC_RELEASE);
+		sharedEventSignal(&wake);
+		pthread_join(thread, NULL);
+	}
+	delete bus;
+}
+
+int IoWorker::addMotor(SlushMotor *motor) {
+	// Every handle to the same SlushEngine motor shares its readings
+	for (int slot = 0; slot < numberOfMotors; slot++) {
+		if (motors[slot]->GetMotorNumber() == motor->GetMotorNumber()) {
+			return slot;
+		}
+	}
+	if (numberOfMotors >= IO_MAX_MOTORS) {
+		printf("Too many motors for the I/O worker.\n");
+		return -1;
+	}
+	motors[numberOfMotors] = motor;
+	bus->attach(numberOfMotors, motor->GetMotorNumber());
+	return numberOfMotors++;
+}
+
+bool IoWorker::start(int avoidCpu) {
+	running = true;
+	if (pthread_create(&thread, NULL, IoWorker::run, this) != 0) {
+		running = false;
+		printf("I/O worker: FAILED to start\n");
+		return false;
+	}
+	// Created threads inherit the real-time loop's core and priority, step aside for it
+	bool moved = true;
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpus > 1) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (int cpu = 0; cpu < cpus; cpu++) {
+			if (cpu != avoidCpu) {
+				CPU_SET(cpu, &set);
+			}
+		}
+		moved = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &set) == 0;
+	}
+	int policy;
+	struct sched_param params;
+	pthread_getschedparam(thread, &policy, &params);
+	if (policy == SCHED_FIFO) {
+		params.sched_priority = sched_get_priority_max(SCHED_FIFO) - 10;
+		pthread_setschedparam(thread, SCHED_FIFO, &params);
+	}
+	printf("I/O worker off CPU %d: %s\n", avoidCpu, moved && cpus > 1 ? "OK" : "no (single core)");
+	return true;
+}
+
+void *IoWorker::run(void *worker) {
+	((IoWorker *) worker)->loop();
+	return NULL;
+}
+
+void IoWorker::loop() {
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	while (__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+		unsigned int sequence = sharedEventSequence(&wake);
+		serviceRequests();
+		int waitReturn = sharedEventWait(&wake, sequence, &next);
+		if (waitReturn == 0 || waitReturn == EINTR) {
+			continue;
+		}
+		if (waitReturn != ETIMEDOUT) {
+			//Keep polling on time rather than spin on a broken wait
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		}
+		serviceRequests();
+		poll();
+		next.tv_nsec += IO_POLL_PERIOD_NS;
+		while (next.tv_nsec >= 1000000000L) {
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+	}
+}
+
+unsigned int IoWorker::push(const IO_REQUEST *request) {
+	IO_REQUEST stage;
+	if (holding && request->operation == IO_MOTOR_GO_TO) {
+		stage = *request;
+		stage.operation = IO_MOTOR_STAGE_GO_TO;
+		request = &stage;
+		held++;
+	}
+	if (!running) {
+		// Nothing else touches the buses yet
+		execute(request);
+		head++;
+		tail++;
+		sampled.requestsDone = tail;
+		sampled.transactions = transactions;
+		memcpy(sampled.motors, polling.motors, sizeof(polling.motors));
+		return head;
+	}
+	unsigned int sequence = head;
+	if (sequence - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= IO_REQUEST_RING_SIZE) {
+		// A lost go to would look arrived and a lost start would hold every staged move, stop instead
+		dropped++;
+		ErrorHandler::getInstance()->addError(ES_IO_REQUEST_DROPPED, EL_STOP);
+		return 0;
+	}
+	requests[sequence & (IO_REQUEST_RING_SIZE - 1)] = *request;
+	__atomic_store_n(&head, sequence + 1, __ATOMIC_RELEASE);
+	sharedEventSignal(&wake);
+	return sequence + 1;
+}
+
+void IoWorker::releaseMotion() {
+	holding = false;
+	if (held == 0) {
+		return;
+	}
+	held = 0;
+	IO_REQUEST request = {};
+	request.operation = IO_MOTORS_START;
+	request.slot = -1;
+	this->push(&request);
+}
+
+void IoWorker::emergencyStop() {
+	if (!running) {
+		stopAllMotors();
+		return;
+	}
+	__atomic_store_n(&stopAt, head, __ATOMIC_RELAXED);
+	__atomic_store_n(&stopPending, true, __ATOMIC_RELEASE);
+	sharedEventSignal(&wake);
+}
+
+void IoWorker::stopAllMotors() {
+	bus->command((1u << numberOfMotors) - 1, L6470_CMD_HARD_STOP);
+	transactions++;
+	staged = 0;
+}
+
+void IoWorker::setSpeeds(unsigned int slots, const IO_REQUEST *const *requests) {
+	unsigned long maxSpeeds[IO_MAX_MOTORS];
+	unsigned long minSpeeds[IO_MAX_MOTORS];
+	for (int slot = 0; slot < numberOfMotors; slot++) {
+		if (slots & (1u << slot)) {
+			if (requests[slot]->maxSpeed > 0) {
+				maxSpeeds[slot] = MotorBus::maxSpeedRegister(requests[slot]->maxSpeed);
+				minSpeeds[slot] = MotorBus::minSpeedRegister(requests[slot]->minSpeed);
+			} else {
+				slots &= ~(1u << slot);
+			}
+		}
+	}
+	if (slots != 0) {
+		bus->setParam(L6470_PARAM_MAX_SPEED, slots, maxSpeeds);
+		bus->setParam(L6470_PARAM_MIN_SPEED, slots, minSpeeds);
+		transactions += 2;
+	}
+}
+
+void IoWorker::startStaged() {
+	if (staged == 0) {
+		return;
+	}
+	const IO_REQUEST *stagedBySlot[IO_MAX_MOTORS];
+	long positions[IO_MAX_MOTORS];
+	for (int slot = 0; slot < numberOfMotors; slot++) {
+		stagedBySlot[slot] = &stagedRequests[slot];
+		positions[slot] = stagedRequests[slot].value;
+		if (staged & (1u << slot)) {
+			positionStale[slot] = true;
+		}
+	}
+	setSpeeds(staged, stagedBySlot);
+	bus->goTo(staged, positions);
+	transactions++;
+	staged = 0;
+}
+
+void IoWorker::serviceRequests() {
+	while (true) {
+		if (__atomic_exchange_n(&stopPending, false, __ATOMIC_ACQUIRE)) {
+			stopAllMotors();
+			dropBefore = __atomic_load_n(&stopAt, __ATOMIC_RELAXED);
+		}
+		unsigned int sequence = tail;
+		if (__atomic_load_n(&head, __ATOMIC_ACQUIRE) == sequence) {
+			return;
+		}
+		IO_REQUEST *request = &requests[sequence & (IO_REQUEST_RING_SIZE - 1)];
+		bool motion = request->operation == IO_MOTOR_MOVE || request->operation == IO_MOTOR_GO_TO
+				|| request->operation == IO_MOTOR_STAGE_GO_TO || request->operation == IO_MOTORS_START
+				|| request->operation == IO_MOTOR_GO_HOME || request->operation == IO_MOTOR_ZERO_RETURN;
+		// Motion queued before an emergency stop must not restart the motors
+		if (!motion || (int) (sequence - dropBefore) >= 0) {
+			execute(request);
+		}
+		__atomic_store_n(&tail, sequence + 1, __ATOMIC_RELEASE);
+	}
+}
+
+void IoWorker::execute(const IO_REQUEST *request) {
+	SlushMotor *motor = request->slot >= 0 && request->slot < numberOfMotors ? motors[request->slot] : NULL;
+	switch (request->operation) {
+	case IO_BOARD_SET_IO:
+		if (board) {
+			board->setIOState((TSlushIOPorts) request->slot, (TSlushIOPins) request->parameter, request->value);
+			transactions++;
+		}
+		return;
+	case IO_VACUUM_START:
+	case IO_VACUUM_STOP: {
+		std::array<int, 2> config { {(int) (request->value >> 8) & 0xFF, (int) request->value & 0xFF} };
+		Registers::writeByte(ADS1x15_DEFAULT_ADDRESS, ADS1x15_POINTER_CONFIG, config);
+		transactions++;
+		vacuumListening = request->operation == IO_VACUUM_START;
+		if (vacuumListening) {
+			// The first conversion still uses the previous configuration
+			Registers::readByte(ADS1x15_DEFAULT_ADDRESS, ADS1x15_POINTER_CONVERSION);
+			transactions++;
+			polling.vacuum.starts++;
+		}
+		return;
+	}
+	case IO_MOTORS_START:
+		startStaged();
+		return;
+	default:
+		break;
+	}
+	if (motor == NULL) {
+		return;
+	}
+	unsigned int slots = 1u << request->slot;
+	if (request->operation == IO_MOTOR_STAGE_GO_TO) {
+		// Requests after the first staged one aren't done until the start
+		if (staged == 0) {
+			stagedAt = tail;
+		}
+		stagedRequests[request->slot] = *request;
+		staged |= slots;
+		return;
+	}
+	positionStale[request->slot] = true;
+	const IO_REQUEST *bySlot[IO_MAX_MOTORS];
+	bySlot[request->slot] = request;
+	setSpeeds(slots, bySlot);
+	switch (request->operation) {
+	case IO_MOTOR_HARD_STOP:
+		bus->command(slots, L6470_CMD_HARD_STOP);
+		break;
+	case IO_MOTOR_SOFT_STOP:
+		bus->command(slots, L6470_CMD_SOFT_STOP);
+		break;
+	case IO_MOTOR_MOVE:
+		motor->move(request->value);
+		break;
+	case IO_MOTOR_GO_TO: {
+		long positions[IO_MAX_MOTORS];
+		positions[request->slot] = request->value;
+		bus->goTo(slots, positions);
+		break;
+	}
+	case IO_MOTOR_GO_HOME:
+		motor->goHome();
+		break;
+	case IO_MOTOR_SET_HOME:
+		bus->command(slots, L6470_CMD_RESET_POS);
+		break;
+	case IO_MOTOR_ZERO_RETURN:
+		// Read the switch now, not from the last poll
+		if (!(motor->getStatus() & L6470_STATUS_SW_F)) {
+			motor->setAsHome();
+		} else {
+			// The switches open when depressed, RELEASE_SW runs at MIN_SPEED until one does then hard stops
+			motor->releaseSw(L6470_ABSPOS_RESET, request->value > 0 ? L6470_DIR_FWD : L6470_DIR_REV);
+		}
+		transactions++;
+		break;
+	case IO_MOTOR_SET_PARAM:
+		motor->setParam((TL6470ParamRegisters) request->parameter, request->value);
+		break;
+	case IO_MOTOR_SET_CURRENT:
+		motor->setCurrent(request->current[0], request->current[1], request->current[2], request->current[3]);
+		// One write per KVAL register
+		transactions += 3;
+		break;
+	case IO_MOTOR_RESET:
+		motor->resetDev();
+		motor->setFullSpeed(request->value);
+		transactions++;
+		break;
+	case IO_MOTOR_READ_STATE: {
+		IO_MOTOR_READING *reading = &polling.motors[request->slot];
+		unsigned long values[IO_MAX_MOTORS];
+		bus->getParam(L6470_PARAM_STATUS, slots, values);
+		reading->status = values[request->slot];
+		reading->busy = !(values[request->slot] & L6470_STATUS_BUSY);
+		bus->getParam(L6470_PARAM_ABS_POS, slots, values);
+		reading->position = MotorBus::toPosition(values[request->slot]);
+		transactions += 2;
+		return;
+	}
+	case IO_MOTOR_SET_ACCEL:
+		motor->setAcc(request->value);
+		motor->setDec(request->parameter);
+		transactions++;
+		break;
+	default:
+		return;
+	}
+	transactions++;
+}
+
+void IoWorker::poll() {
+	polling.requestsDone = staged ? stagedAt : tail;
+	unsigned int all = (1u << numberOfMotors) - 1;
+	unsigned int moving = 0;
+	unsigned int busy = 0;
+	// Every motor's STATUS in the same transfer
+	unsigned int statusDue = polls % IO_STATUS_POLL_PERIOD == 0 ? all : 0;
+	unsigned long values[IO_MAX_MOTORS];
+	if (numberOfMotors > 0) {
+		// Like SlushMotor::isBusy, from the STATUS register without clearing its flags
+		bus->getParam(L6470_PARAM_STATUS, all, values);
+		transactions++;
+	}
+	for (int slot = 0; slot < numberOfMotors; slot++) {
+		IO_MOTOR_READING *reading = &polling.motors[slot];
+		unsigned int bit = 1u << slot;
+		if (!(values[slot] & L6470_STATUS_BUSY)) {
+			busy |= bit;
+		}
+		// Read once more after the motor stops, to catch where it came to rest
+		if ((busy & bit) || reading->busy || positionStale[slot]) {
+			positionStale[slot] = false;
+			moving |= bit;
+		}
+		reading->busy = busy & bit;
+	}
+	if (__atomic_load_n(&stopPending, __ATOMIC_ACQUIRE)) {
+		serviceRequests();
+	}
+	if (moving) {
+		bus->getParam(L6470_PARAM_ABS_POS, moving, values);
+		transactions++;
+		for (int slot = 0; slot < numberOfMotors; slot++) {
+			if (moving & (1u << slot)) {
+				polling.motors[slot].position = MotorBus::toPosition(values[slot]);
+				polling.motors[slot].speed = 0;
+			}
+		}
+	}
+	if (busy) {
+		bus->getParam(L6470_PARAM_SPEED, busy, values);
+		transactions++;
+		for (int slot = 0; slot < numberOfMotors; slot++) {
+			if (busy & (1u << slot)) {
+				polling.motors[slot].speed = values[slot] / IO_SPEED_UNITS_PER_STEP_PER_SEC;
+			}
+		}
+	}
+	if (statusDue) {
+		bus->getStatus(statusDue, values);
+		transactions++;
+		for (int slot = 0; slot < numberOfMotors; slot++) {
+			if (statusDue & (1u << slot)) {
+				polling.motors[slot].status = values[slot];
+				polling.motors[slot].statusSequence++;
+			}
+		}
+	}
+	if (__atomic_load_n(&stopPending, __ATOMIC_ACQUIRE)) {
+		serviceRequests();
+	}
+	if (vacuumListening) {
+		std::array<uint8_t, 2> conversion = Registers::readByte(ADS1x15_DEFAULT_ADDRESS, ADS1x15_POINTER_CONVERSION);
+		polling.vacuum.conversion = (conversion[0] << 8) | conversion[1];
+		polling.vacuum.samples++;
+		transactions++;
+	}
+	polling.transactions = transactions;
+	unsigned int next = latest ^ 1;
+	seqlockWrite(&buffers[next].lock, &buffers[next].readings, &polling, sizeof(IO_READINGS));
+	__atomic_store_n(&latest, next, __ATOMIC_RELEASE);
+	polls++;
+}
+
+void IoWorker::sample() {
+	if (!running) {
+		return;
+	}
+	IO_READINGS readings;
+	unsigned int newest = __atomic_load_n(&latest, __ATOMIC_ACQUIRE);
+	// The other buffer is only rewritten once the worker laps this reader
+	if (seqlockTryRead(&buffers[newest].lock, &readings, &buffers[newest].readings, sizeof(IO_READINGS))
+			|| seqlockTryRead(&buffers[newest ^ 1].lock, &readings, &buffers[newest ^ 1].readings, sizeof(IO_READINGS))) {
+		memcpy(&sampled, &readings, sizeof(IO_READINGS));
+	}
+}
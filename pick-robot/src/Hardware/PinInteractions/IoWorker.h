@@ -0,0 +1,285 @@
+#ifndef SRC_HARDWARE_PININTERACTIONS_IOWORKER_H_
+#define SRC_HARDWARE_PININTERACTIONS_IOWORKER_H_
+
+/**
+ * @file IoWorker.h
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <SeqLock.h>
+#include <SharedEvent.h>
+
+#include "MotorBus.h"
+
+class SlushBoard;
+class SlushMotor;
+
+/** Number of SlushEngine motors the worker can own. */
+#define IO_MAX_MOTORS MOTOR_BUS_MAX_DRIVERS
+/** Number of queued hardware requests, must be a power of two. */
+#define IO_REQUEST_RING_SIZE 64
+/** Nanoseconds between polls of the motor positions and the vacuum sensor. */
+#define IO_POLL_PERIOD_NS 1000000L
+/** Polls between reads of each motor's STATUS register, reading it clears the warning flags. */
+#define IO_STATUS_POLL_PERIOD 20
+/** L6470 SPEED register units per step/second, the register counts steps per 2^28 ticks of 250 ns. */
+#define IO_SPEED_UNITS_PER_STEP_PER_SEC 67.108864
+
+/**
+ * @enum IO_OPERATION
+ * @brief Hardware requests the real-time loop can queue.
+ */
+enum IO_OPERATION {
+	IO_MOTOR_HARD_STOP,		/**< Stop immediately */
+	IO_MOTOR_SOFT_STOP,		/**< Decelerate to a stop */
+	IO_MOTOR_SET_SPEED,		/**< Set #IO_REQUEST::maxSpeed and #IO_REQUEST::minSpeed */
+	IO_MOTOR_MOVE,			/**< Set the speeds, then move #IO_REQUEST::value microsteps */
+	IO_MOTOR_GO_TO,			/**< Set the speeds, then go to microstep #IO_REQUEST::value */
+	IO_MOTOR_STAGE_GO_TO,	/**< An #IO_MOTOR_GO_TO held back for the next #IO_MOTORS_START */
+	IO_MOTORS_START,		/**< Start every staged go to at once */
+	IO_MOTOR_GO_HOME,		/**< Go to the home position */
+	IO_MOTOR_SET_HOME,		/**< Make the current position home */
+	IO_MOTOR_ZERO_RETURN,	/**< Set the speeds, then run at #IO_REQUEST::minSpeed in direction #IO_REQUEST::value until the limit switch is depressed */
+	IO_MOTOR_SET_PARAM,		/**< Write #IO_REQUEST::value to register #IO_REQUEST::parameter */
+	IO_MOTOR_SET_CURRENT,	/**< Set the KVALs from #IO_REQUEST::current, then #IO_REQUEST::maxSpeed */
+	IO_MOTOR_RESET,			/**< Reset the driver, then set its full-step speed to #IO_REQUEST::value */
+	IO_MOTOR_READ_STATE,	/**< Read STATUS, without clearing its flags, and ABS_POS into the motor's reading */
+	IO_MOTOR_SET_ACCEL,		/**< Set the acceleration to #IO_REQUEST::value and deceleration to #IO_REQUEST::parameter, steps/second² */
+	IO_BOARD_SET_IO,		/**< Set IO pin #IO_REQUEST::parameter of port #IO_REQUEST::slot to #IO_REQUEST::value */
+	IO_VACUUM_START,		/**< Write ADS1115 config #IO_REQUEST::value and read conversions continuously */
+	IO_VACUUM_STOP			/**< Write ADS1115 config #IO_REQUEST::value and stop reading */
+};
+
+/**
+ * @typedef IO_REQUEST
+ * @brief A queued hardware request.
+ */
+typedef struct {
+	IO_OPERATION operation;		/**< What to do */
+	int slot;					/**< The motor, from IoWorker::addMotor */
+	long value;					/**< Steps, position, direction or register value */
+	int parameter;				/**< Register or pin */
+	float maxSpeed;				/**< Steps/second, ignored if not positive */
+	float minSpeed;				/**< Steps/second */
+	uint8_t current[4];			/**< Hold, run, acceleration and deceleration KVAL */
+} IO_REQUEST;
+
+/**
+ * @typedef IO_MOTOR_READING
+ * @brief The last polled state of a motor.
+ */
+typedef struct {
+	long position;					/**< Absolute position in microsteps */
+	float speed;					/**< Speed in steps/second regardless of direction, 0 when not busy */
+	bool busy;						/**< The BUSY pin */
+	uint16_t status;				/**< The last STATUS register read */
+	unsigned int statusSequence;	/**< Incremented on every STATUS register read */
+} IO_MOTOR_READING;
+
+/**
+ * @typedef IO_VACUUM_READING
+ * @brief The last polled vacuum sensor conversion.
+ */
+typedef struct {
+	uint16_t conversion;		/**< Raw conversion register, high byte first */
+	unsigned int samples;		/**< Incremented on every conversion read */
+	unsigned int starts;		/**< Number of #IO_VACUUM_START executed */
+} IO_VACUUM_READING;
+
+/**
+ * @typedef IO_READINGS
+ * @brief Everything the worker polled in one pass, the snapshot every consumer reads during a tick.
+ */
+typedef struct __attribute__((aligned(64))) {
+	IO_MOTOR_READING motors[IO_MAX_MOTORS];		/**< Indexed by slot */
+	IO_VACUUM_READING vacuum;					/**< The vacuum sensor */
+	unsigned int requestsDone;					/**< Requests executed (or dropped) before this poll */
+	unsigned int transactions;					/**< Bus transfers issued, setup included, a batched transfer to several drivers counts once */
+} IO_READINGS;
+
+/**
+ * @class IoWorker
+ * @brief Owns the SPI and I2C buses so the real-time loop never waits on them.
+ *
+ * The real-time loop queues #IO_REQUEST on a lock-free ring and consumes the
+ * 	latest complete #IO_READINGS, sampled once per tick by #sample. The worker
+ * 	thread executes requests as they arrive and polls the hardware every
+ * 	#IO_POLL_PERIOD_NS, publishing into two alternating buffers. A motor's
+ * 	ABS_POS and SPEED are only read while it is busy or after a request for it,
+ * 	a stopped stepper can't have moved.
+ *
+ * Polls, stops and go tos reach the drivers through a #MotorBus, each register
+ * 	read from every motor in one transfer. Go tos pushed between #holdMotion and
+ * 	#releaseMotion start together, within a byte of each other on the bus.
+ *
+ * #emergencyStop bypasses the ring: the worker hard stops every motor before
+ * 	its next request and drops the motion requests queued before the stop.
+ *
+ * Until #start is called requests execute synchronously on the caller, so
+ * 	hardware can be set up from constructors.
+ */
+class IoWorker {
+private:
+	/** A published #IO_READINGS */
+	typedef struct {
+		SEQLOCK lock;				/**< Detects the worker lapping a slow reader */
+		IO_READINGS readings;		/**< The readings */
+	} BUFFER;
+
+	/** Registered motors, indexed by slot */
+	SlushMotor *motors[IO_MAX_MOTORS];
+	/** Number of registered motors */
+	int numberOfMotors;
+	/** Whether a request may have moved each motor since its position was read, owned by the worker */
+	bool positionStale[IO_MAX_MOTORS];
+	/** The board driving the IO pins */
+	SlushBoard *board;
+	/** Batched access to the motors' drivers */
+	MotorBus *bus;
+	/** Slots with a staged go to, owned by the worker */
+	unsigned int staged;
+	/** Each slot's staged go to */
+	IO_REQUEST stagedRequests[IO_MAX_MOTORS];
+	/** Requests done before the first staged go to, reported until the start */
+	unsigned int stagedAt;
+
+	/** Queued requests */
+	IO_REQUEST requests[IO_REQUEST_RING_SIZE];
+	/** Requests pushed, written by the real-time loop */
+	unsigned int head __attribute__((aligned(64)));
+	/** Requests popped, written by the worker */
+	unsigned int tail __attribute__((aligned(64)));
+	/** Requests that found the ring full */
+	unsigned int dropped;
+	/** Wakes the worker when a request is queued */
+	SHARED_EVENT wake;
+	/** Whether an #emergencyStop is waiting for the worker */
+	bool stopPending;
+	/** #head as of the last #emergencyStop */
+	unsigned int stopAt;
+	/** Motion requests before this sequence are dropped, owned by the worker */
+	unsigned int dropBefore;
+	/** Whether go tos are being held for #releaseMotion, owned by the real-time loop */
+	bool holding;
+	/** Go tos held since #holdMotion */
+	unsigned int held;
+
+	/** Alternating published readings */
+	BUFFER buffers[2];
+	/** Index of the last complete buffer */
+	unsigned int latest;
+	/** The worker's readings being polled */
+	IO_READINGS polling;
+	/** The real-time loop's copy, from #sample */
+	IO_READINGS sampled;
+	/** Whether the vacuum sensor is being read */
+	bool vacuumListening;
+	/** Number of polls completed */
+	unsigned int polls;
+	/** Bus transactions issued, owned by the worker until #start */
+	unsigned int transactions;
+
+	/** The worker thread */
+	pthread_t thread;
+	/** Whether the worker thread is running */
+	bool running;
+
+	IoWorker();
+
+	static void *run(void *worker);
+	void loop();
+	void execute(const IO_REQUEST *request);
+	void serviceRequests();
+	void stopAllMotors();
+	void setSpeeds(unsigned int slots, const IO_REQUEST *const *requests);
+	void startStaged();
+	void poll();
+
+public:
+	/**
+	 * @static
+	 * @brief The worker owning the buses.
+	 */
+	static IoWorker *getInstance() {
+		static IoWorker instance;
+		return &instance;
+	}
+	virtual ~IoWorker();
+
+	/**
+	 * @fn addMotor
+	 * @brief Hand a motor to the worker. Call before #start. Motors with the same number share a slot.
+	 * @return The motor's slot in #IO_READINGS::motors, or -1 if #IO_MAX_MOTORS are registered.
+	 */
+	int addMotor(SlushMotor *motor);
+
+	/**
+	 * @fn setBoard
+	 * @brief Hand the board driving the IO pins to the worker. Call before #start.
+	 */
+	void setBoard(SlushBoard *board) {
+		this->board = board;
+	}
+
+	/**
+	 * @fn start
+	 * @brief Start the worker thread, below the real-time loop's priority and off its core.
+	 * @param[in] avoidCpu The real-time loop's core, the worker runs on any other.
+	 * @return Whether the thread started.
+	 */
+	bool start(int avoidCpu);
+
+	/**
+	 * @fn push
+	 * @brief Queue a request without blocking. Only the real-time loop may call this.
+	 * @param[in] request The request.
+	 * @return The request's sequence number, compare with #IO_READINGS::requestsDone.
+	 * 	0 if the ring was full and the request was dropped, which raises #ES_IO_REQUEST_DROPPED at #EL_STOP.
+	 */
+	unsigned int push(const IO_REQUEST *request);
+
+	/**
+	 * @fn holdMotion
+	 * @brief Hold back the go tos pushed from now on until #releaseMotion. Only the real-time loop may call this.
+	 */
+	void holdMotion() {
+		holding = true;
+	}
+
+	/**
+	 * @fn releaseMotion
+	 * @brief Start the go tos held since #holdMotion together.
+	 */
+	void releaseMotion();
+
+	/**
+	 * @fn emergencyStop
+	 * @brief Hard stop every motor ahead of any queued request, dropping queued motion.
+	 */
+	void emergencyStop();
+
+	/**
+	 * @fn sample
+	 * @brief Copy the latest complete readings for this tick. Never blocks.
+	 */
+	void sample();
+
+	/**
+	 * @fn getReadings
+	 * @return The readings of the last #sample.
+	 */
+	const IO_READINGS *getReadings() {
+		return &sampled;
+	}
+
+	/**
+	 * @fn getDropped
+	 * @return The number of requests dropped because the ring was full.
+	 */
+	unsigned int getDropped() {
+		return dropped;
+	}
+};
+
+#endif /* SRC_HARDWARE_PININTERACTIONS_IOWORKER_H_ */
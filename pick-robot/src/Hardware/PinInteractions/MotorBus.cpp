@@ -0,0 +1,86 @@
+#include "MotorBus.h"
+
+#include <l6470constants.h>
+#include <math.h>
+#include <string.h>
+
+/** Register lengths in bits, indexed by TL6470ParamRegisters */
+static const uint8_t PARAM_BITS[L6470_PARAM_STATUS + 1] = {
+	0, 22, 9, 22, 20, 12, 12, 10, 13, 8, 8, 8, 8, 14, 8, 8, 8, 8, 8, 8, 8, 10, 8, 8, 16, 16
+};
+
+int MotorBus::getParamLength(TL6470ParamRegisters param) {
+	return param <= L6470_PARAM_STATUS ? (PARAM_BITS[param] + 7) / 8 : 0;
+}
+
+long MotorBus::toPosition(unsigned long absPos) {
+	absPos &= 0x3FFFFF;
+	return absPos & 0x200000 ? (long) absPos - 0x400000 : (long) absPos;
+}
+
+unsigned long MotorBus::maxSpeedRegister(float stepsPerSec) {
+	// Rounded up, a driver with MAX_SPEED 0 never moves
+	double value = ceil(stepsPerSec * .065536);
+	if (value < 1) {
+		return 1;
+	}
+	return value > 0x3FF ? 0x3FF : (unsigned long) value;
+}
+
+unsigned long MotorBus::minSpeedRegister(float stepsPerSec) {
+	unsigned long value = (unsigned long) (stepsPerSec * 4.1943);
+	return value > L6470_MIN_SPEED_MASK ? L6470_MIN_SPEED_MASK : value;
+}
+
+void MotorBus::read(uint8_t command, int length, unsigned int slots, unsigned long *values) {
+	MOTOR_BUS_FRAMES frames;
+	memset(frames, L6470_CMD_NOP, sizeof(frames));
+	memset(frames[0], command, MOTOR_BUS_MAX_DRIVERS);
+	this->transfer(frames, length + 1, slots);
+	for (int slot = 0; slot < MOTOR_BUS_MAX_DRIVERS; slot++) {
+		if (slots & (1u << slot)) {
+			values[slot] = 0;
+			for (int byte = 1; byte <= length; byte++) {
+				values[slot] = (values[slot] << 8) | frames[byte][slot];
+			}
+		}
+	}
+}
+
+void MotorBus::getParam(TL6470ParamRegisters param, unsigned int slots, unsigned long *values) {
+	this->read(L6470_CMD_GET_PARAM | param, getParamLength(param), slots, values);
+}
+
+void MotorBus::getStatus(unsigned int slots, unsigned long *values) {
+	this->read(L6470_CMD_GET_STATUS, 2, slots, values);
+}
+
+void MotorBus::setParam(TL6470ParamRegisters param, unsigned int slots, const unsigned long *values) {
+	int length = getParamLength(param);
+	MOTOR_BUS_FRAMES frames;
+	for (int slot = 0; slot < MOTOR_BUS_MAX_DRIVERS; slot++) {
+		frames[0][slot] = L6470_CMD_SET_PARAM | param;
+		for (int byte = 1; byte <= length; byte++) {
+			frames[byte][slot] = (values[slot] >> (8 * (length - byte))) & 0xFF;
+		}
+	}
+	this->transfer(frames, length + 1, slots);
+}
+
+void MotorBus::goTo(unsigned int slots, const long *positions) {
+	MOTOR_BUS_FRAMES frames;
+	for (int slot = 0; slot < MOTOR_BUS_MAX_DRIVERS; slot++) {
+		unsigned long position = positions[slot] & 0x3FFFFF;
+		frames[0][slot] = L6470_CMD_GOTO;
+		frames[1][slot] = (position >> 16) & 0xFF;
+		frames[2][slot] = (position >> 8) & 0xFF;
+		frames[3][slot] = position & 0xFF;
+	}
+	this->transfer(frames, 4, slots);
+}
+
+void MotorBus::command(unsigned int slots, uint8_t command) {
+	MOTOR_BUS_FRAMES frames;
+	memset(frames[0], command, MOTOR_BUS_MAX_DRIVERS);
+	this->transfer(frames, 1, slots);
+}
@@ -0,0 +1,116 @@
+#ifndef SRC_HARDWARE_PININTERACTIONS_MOTORBUS_H_
+#define SRC_HARDWARE_PININTERACTIONS_MOTORBUS_H_
+
+/**
+ * @file MotorBus.h
+ */
+
+#include <stdint.h>
+#include <l6470.h>
+
+/** Number of L6470 drivers on the bus, one per SlushEngine motor. */
+#define MOTOR_BUS_MAX_DRIVERS 4
+/** Longest L6470 frame: a command and a 3 byte argument or reply. */
+#define MOTOR_BUS_MAX_FRAME 4
+
+/**
+ * @typedef MOTOR_BUS_FRAMES
+ * @brief One transfer, byte by byte, each byte sent to every selected driver in slot order.
+ */
+typedef uint8_t MOTOR_BUS_FRAMES[MOTOR_BUS_MAX_FRAME][MOTOR_BUS_MAX_DRIVERS];
+
+/**
+ * @class MotorBus
+ * @brief The SPI transport to the L6470 drivers, one transfer talks to several drivers at once.
+ *
+ * A transfer sends byte 0 to every selected driver, then byte 1, and so on, so the
+ * 	same command reaches all of them within one byte of each other: the drivers
+ * 	latch a command on the rising chip select of its last byte. The helpers encode
+ * 	the L6470 commands the #IoWorker batches; everything else still goes through
+ * 	libl6470, one driver at a time.
+ *
+ * Drivers are selected by a mask of slots, bit n for slot n.
+ */
+class MotorBus {
+private:
+	void read(uint8_t command, int length, unsigned int slots, unsigned long *values);
+
+public:
+	virtual ~MotorBus() {}
+
+	/**
+	 * @fn attach
+	 * @brief Address SlushEngine motor @p motorNumber as @p slot.
+	 */
+	virtual void attach(int slot, int motorNumber) = 0;
+
+	/**
+	 * @fn transfer
+	 * @brief Exchange @p length bytes with every driver in @p slots, full duplex.
+	 * @param[in,out] frames The bytes to send, replaced by the bytes received.
+	 * @param[in] length Bytes per driver, at most #MOTOR_BUS_MAX_FRAME.
+	 * @param[in] slots The selected drivers.
+	 */
+	virtual void transfer(MOTOR_BUS_FRAMES frames, int length, unsigned int slots) = 0;
+
+	/**
+	 * @fn getParam
+	 * @brief Read the same register from every driver in @p slots in one transfer.
+	 * @param[out] values Indexed by slot, unselected slots are left alone.
+	 */
+	void getParam(TL6470ParamRegisters param, unsigned int slots, unsigned long *values);
+
+	/**
+	 * @fn getStatus
+	 * @brief Read and clear the STATUS register of every driver in @p slots in one transfer.
+	 * @param[out] values Indexed by slot, unselected slots are left alone.
+	 */
+	void getStatus(unsigned int slots, unsigned long *values);
+
+	/**
+	 * @fn setParam
+	 * @brief Write each driver in @p slots its own value of the same register in one transfer.
+	 * @param[in] values Indexed by slot.
+	 */
+	void setParam(TL6470ParamRegisters param, unsigned int slots, const unsigned long *values);
+
+	/**
+	 * @fn goTo
+	 * @brief Send every driver in @p slots to its own absolute microstep position, starting together.
+	 * @param[in] positions Indexed by slot.
+	 */
+	void goTo(unsigned int slots, const long *positions);
+
+	/**
+	 * @fn command
+	 * @brief Send an argument-less command (e.g. L6470_CMD_HARD_STOP) to every driver in @p slots.
+	 */
+	void command(unsigned int slots, uint8_t command);
+
+	/**
+	 * @fn getParamLength
+	 * @return Bytes register @p param takes on the bus.
+	 */
+	static int getParamLength(TL6470ParamRegisters param);
+
+	/**
+	 * @fn toPosition
+	 * @return The signed position held in a 22 bit ABS_POS value.
+	 */
+	static long toPosition(unsigned long absPos);
+
+	/**
+	 * @fn maxSpeedRegister
+	 * @return The MAX_SPEED value for @p stepsPerSec, rounded up as libl6470 computes it and at least 1.
+	 */
+	static unsigned long maxSpeedRegister(float stepsPerSec);
+
+	/**
+	 * @fn minSpeedRegister
+	 * @return The MIN_SPEED value for @p stepsPerSec with low speed optimisation off, as libl6470 computes it.
+	 * 	Speeds above #HOMING_MAX_STEPS_PER_SEC are clamped to the largest value.
+	 */
+	static unsigned long minSpeedRegister(float stepsPerSec);
+};
+
+#endif /* SRC_HARDWARE_PININTERACTIONS_MOTORBUS_H_ */
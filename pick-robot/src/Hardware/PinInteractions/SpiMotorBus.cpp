@@ -0,0 +1,37 @@
+#include "SpiMotorBus.h"
+
+#include <bcm2835.h>
+#include <slushboard.h>
+
+static const uint8_t CHIP_SELECTS[MOTOR_BUS_MAX_DRIVERS] = {
+	SLUSH_MTR0_CHIPSELECT, SLUSH_MTR1_CHIPSELECT, SLUSH_MTR2_CHIPSELECT, SLUSH_MTR3_CHIPSELECT
+};
+
+SpiMotorBus::SpiMotorBus() {
+	for (int slot = 0; slot < MOTOR_BUS_MAX_DRIVERS; slot++) {
+		chipSelects[slot] = CHIP_SELECTS[slot];
+	}
+}
+
+void SpiMotorBus::attach(int slot, int motorNumber) {
+	if (slot >= 0 && slot < MOTOR_BUS_MAX_DRIVERS && motorNumber >= 0 && motorNumber < MOTOR_BUS_MAX_DRIVERS) {
+		chipSelects[slot] = CHIP_SELECTS[motorNumber];
+	}
+}
+
+void SpiMotorBus::transfer(MOTOR_BUS_FRAMES frames, int length, unsigned int slots) {
+	// libl6470 sets these before every byte, once per transfer is enough
+	bcm2835_spi_chipSelect(BCM2835_SPI_CS_NONE);
+	bcm2835_spi_setDataMode(BCM2835_SPI_MODE3);
+	bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_64);
+	for (int byte = 0; byte < length; byte++) {
+		// A driver's chip select stays high while the others are addressed, well over the 800 ns it needs
+		for (int slot = 0; slot < MOTOR_BUS_MAX_DRIVERS; slot++) {
+			if (slots & (1u << slot)) {
+				bcm2835_gpio_clr(chipSelects[slot]);
+				frames[byte][slot] = bcm2835_spi_transfer(frames[byte][slot]);
+				bcm2835_gpio_set(chipSelects[slot]);
+			}
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef SRC_HARDWARE_PININTERACTIONS_SPIMOTORBUS_H_
+#define SRC_HARDWARE_PININTERACTIONS_SPIMOTORBUS_H_
+
+/**
+ * @file SpiMotorBus.h
+ */
+
+#include "MotorBus.h"
+
+/**
+ * @class SpiMotorBus
+ * @brief The SlushEngine's SPI bus, one chip select per L6470.
+ *
+ * The drivers are not daisy chained, so a transfer walks the chip selects once per
+ * 	byte. The bus is set up once per transfer instead of once per byte, and no
+ * 	driver waits for another's whole command before its own starts.
+ *
+ * The SPI bus must already be started, as SlushBoard does.
+ */
+class SpiMotorBus : public MotorBus {
+private:
+	/** Chip select pin of each slot */
+	uint8_t chipSelects[MOTOR_BUS_MAX_DRIVERS];
+
+public:
+	SpiMotorBus();
+	virtual ~SpiMotorBus() {}
+
+	void attach(int slot, int motorNumber);
+	void transfer(MOTOR_BUS_FRAMES frames, int length, unsigned int slots);
+};
+
+#endif /* SRC_HARDWARE_PININTERACTIONS_SPIMOTORBUS_H_ */
@@ -8,8 +8,11 @@
 #include "StatusRegister.h"
 
 void StatusRegister::updateStatus(SlushMotor *motor) {
+	this->updateStatus((uint16_t) motor->getStatus());
+}
+
+void StatusRegister::updateStatus(uint16_t retval) {
 	this->numberOfErrors = 0;
-	uint16_t retval = motor->getStatus();
 
 	this->boardStatus[BOARD_STATUS::BF_HIGH_IMPEDANCE_STATE] = (retval & 0x1);
 	this->boardStatus[BOARD_STATUS::BF_BUSY] = !((retval & 0x2) >> 1);
@@ -100,6 +100,13 @@ public:
 	 */
 	void updateStatus(SlushMotor *motor);
 
+	/**
+	 * @fn updateStatus(uint16_t retval)
+	 * @brief Decode a STATUS register value already read from the l6470 chip, see #updateStatus.
+	 * 	@param[in] retval The STATUS register.
+	 */
+	void updateStatus(uint16_t retval);
+
 	/**
 	 * @fn resetStatusReg
 	 * @brief Sets #numberOfErrors to 0 and resets the errors observed by the l6470 chip.
@@ -15,6 +15,7 @@
 #include "../../Hardware/Gripper/Gripper.h"
 #include "../../Hardware/Motors/MotorInterface.h"
 #include "../../Utilities/Axis.h"
+#include "../../Utilities/PositionSnapshot.h"
 #include "../ErrorHandler/ErrorHandler.h"
 #include "../MotorController/MotorController.h"
 #include "../PickControl/PickControl.h"
@@ -34,11 +35,11 @@ CommandHandler::CommandHandler(SharedMemory * sm, PickControl* pc, ZeroReturnCon
 CommandHandler::~CommandHandler() {
 }
 
-void CommandHandler::processCommand(ROBOT_IN *block) {
+void CommandHandler::processCommand(COMMAND_STRUCT *command, JSON_CONFIG *config) {
 	if (pc->getState() == PC_READY && zeroController->getState() == ZR_IDLE && zeroController->isZeroed()) {
 		//Commands that require pick process not started and ready
 		std::array<axis_pos, NUM_AXES> target;
-		switch (block->commandStruct.command) {
+		switch (command->command) {
 			case COMMAND_PICK_ITEM:
 				pc->setState(PC_WAIT_FOR_MOTION);
 				pc->setNextState(PC_PICK_COMMAND_RECEIVED);
@@ -47,19 +48,18 @@ void CommandHandler::processCommand(ROBOT_IN *block) {
 			case COMMAND_TARGET:
 				pc->setState(PC_TARGET_FOUND);
 				pc->setNextState(PC_AT_PICK_POSITION_XY);
-				std::copy(std::begin(block->commandStruct.axisCommand), std::end(block->commandStruct.axisCommand),
+				std::copy(std::begin(command->axisCommand), std::end(command->axisCommand),
 						std::begin(target));
 				targetGenerator->setPickTarget(target);
-				motorController->setTarget(X, block->commandStruct.axisCommand[X]);
-				motorController->setTarget(Y, block->commandStruct.axisCommand[Y]);
+				motorController->setCoordinatedTarget(X, command->axisCommand[X], Y, command->axisCommand[Y]);
 				motorController->setTarget(Z, targetGenerator->getTopOfBoxZ());
 				break;
 			case COMMAND_AXIS:
 				std::array<axis_pos, NUM_AXES> currentTarget;
 				for (int i = 0; i < NUM_AXES; i++) {
 					target[i] =
-							block->commandStruct.axisCommand[i] <= 0 ?
-									block->commandStruct.axisCommand[i] : currentTarget[i];
+							command->axisCommand[i] <= 0 ?
+									command->axisCommand[i] : currentTarget[i];
 				}
 				motorController->setTarget(target);
 				pc->setState(PC_WAIT_FOR_MOTION);
@@ -67,7 +67,7 @@ void CommandHandler::processCommand(ROBOT_IN *block) {
 		}
 	}
 	//Commands that don't require motion ready
-	switch (block->commandStruct.command) {
+	switch (command->command) {
 		case COMMAND_NEW_BOX_ADDED:
 			targetGenerator->newBoxAdded();
 			break;
@@ -78,7 +78,7 @@ void CommandHandler::processCommand(ROBOT_IN *block) {
 			break;
 		case COMMAND_ZERO_RETURN:
 			if ((pc->getState() == PC_READY || pc->getState() == PC_NEEDS_ZERO)
-					&& !block->config.runtimeFlags.emergencyStop) {
+					&& !config->runtimeFlags.emergencyStop) {
 				pc->setState(PC_ZERO_RETURN);
 				ErrorHandler::getInstance()->reset();
 			}
@@ -92,20 +92,29 @@ void CommandHandler::processCommand(ROBOT_IN *block) {
 		case COMMAND_PLACE:
 			if (pc->getState() == PC_AT_DROPOFF_XYZ) {
 				std::array<axis_pos, NUM_AXES> dropLocation;
-				dropLocation[X] = block->commandStruct.axisCommand[X];
+				dropLocation[X] = command->axisCommand[X];
 				dropLocation[Y] = motorController->getPosition(Y);
-				dropLocation[Z] = block->commandStruct.axisCommand[Z];
+				dropLocation[Z] = command->axisCommand[Z];
 				motorController->setTarget(dropLocation);
 				pc->setState(PC_MOVE_TO_NEW_DROPOFF);
 			}
 			break;
-		case COMMAND_LOAD_CONFIG:
+		case COMMAND_LOAD_CONFIG: {
+			// Home still holds if nothing was moving and steps still map to the same positions
+			uint32_t geometry = PositionSnapshot::getGeometry(config->axes);
+			bool keepZero = motorController->hasReachedTarget() && zeroController->getState() == ZR_IDLE
+					&& geometry == zeroController->getGeometry();
 			motorController->emergencyStop();
-			motorController->updateConfig(block->config.axes);
-			targetGenerator->updateConfig(&(block->config.targetGeneratorConfig));
-			zeroController->clearZero();
+			motorController->updateConfig(config->axes);
+			targetGenerator->updateConfig(&(config->targetGeneratorConfig));
+			pc->setBlendMotion(config->runtimeFlags.blendMotion);
+			zeroController->setGeometry(geometry);
+			if (!keepZero) {
+				zeroController->clearZero();
+			}
 			pc->setState(PC_READY);
 			break;
+		}
 		case COMMAND_VAC_ON:
 			gripper->activate();
 			break;
@@ -121,7 +130,7 @@ void CommandHandler::processCommand(ROBOT_IN *block) {
 			zeroController->reset();
 			zeroController->isZeroed() ? pc->setState(PC_READY) : pc->setState(PC_NEEDS_ZERO);
 			gripper->deactivate();
-			block->config.runtimeFlags.emergencyStop = false;
+			config->runtimeFlags.emergencyStop = false;
 			break;
 		case COMMAND_IDLE:
 		default:
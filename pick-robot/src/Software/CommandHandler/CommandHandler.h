@@ -27,7 +27,7 @@ class PickControl;
  * @brief Responsible for handling commands passed through the socket connection.
  *
  * If a command is deemed valid by the @ref pick-trigger-app, then said command is then
- * 	passed to the robot through #ROBOT_IN. Based on the command, the current state
+ * 	queued for the robot on the #COMMAND_RING. Based on the command, the current state
  * 	#PICK_STATE, and whether the machine has been zeroed, the command will either be handled
  * 	appropriately or ignored.
  *
@@ -81,10 +81,11 @@ public:
 
 	/**
 	 * @fn processCommand
-	 * @brief Handles valid commands passed from @ref pick-trigger-app via #ROBOT_IN.
-	 * @param rin A reference to #ROBOT_IN
+	 * @brief Handles valid commands passed from @ref pick-trigger-app via the #COMMAND_RING.
+	 * @param command A reference to the popped #COMMAND_STRUCT.
+	 * @param config A reference to the latest #JSON_CONFIG received through the #ROBOT_CONFIG_SEGMENT.
 	 */
-	void processCommand(ROBOT_IN* rin);
+	void processCommand(COMMAND_STRUCT* command, JSON_CONFIG* config);
 };
 
 #endif /* SRC_SOFTWARE_COMMANDHANDLER_COMMANDHANDLER_H_ */
@@ -1,29 +1,36 @@
 #include "MotorController.h"
 
 #include <SharedMemoryStructs.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 #include "../../Hardware/Motors/MotorInterface.h"
+#include "../../Hardware/PinInteractions/IoWorker.h"
 #include "../ErrorHandler/ErrorHandler.h"
 
+#define MOTOR_CONTROLLER_COST_US 30
+
 
 void MotorController::step(long long int clockTicks) {
+	this->clockTicks = clockTicks;
 	ERROR_LEVEL currLevel = ErrorHandler::getInstance()->getErrorLevel();
 	if (currLevel >= EL_STOP && this->errorLevel < EL_STOP) {
 		this->emergencyStop();
 	}
-	for (Axis *axis : this->axes) {
-		for (MotorInterface *motor : axis->getMotorObj()) {
-			motor->step(clockTicks);
-		}
-	}
 	this->errorLevel = currLevel;
 }
 
+unsigned int MotorController::getStepCostUs() {
+	return MOTOR_CONTROLLER_COST_US;
+}
+
 void MotorController::reportStatus(void *ptr) {
 	ROBOT_OUT * rout = (ROBOT_OUT *) ptr;
 	for (int i = 0; i < NUM_AXES; i++) {
 		rout->axisStatus.axisPosition[i] = axes[i]->getCurrentPositionMM();
 		rout->axisStatus.targetPosition[i] = this->targets[i];
+		rout->axisStatus.etaMs[i] = this->getTimeToTarget((AXIS) i) * SEC_TO_MILL;
 	}
 	rout->axisStatus.isBusy = !this->hasReachedTarget();
 }
@@ -31,33 +38,142 @@ void MotorController::reportStatus(void *ptr) {
 void MotorController::setTarget(AXIS axis, axis_pos position) {
 	if (this->canMove(axis, position)) {
 		targets[axis] = position;
+		// Motors sharing the axis start together
+		IoWorker::getInstance()->holdMotion();
 		axes.at(axis)->goToTarget(position);
+		IoWorker::getInstance()->releaseMotion();
+		this->planMotion(axis, position, 0);
 	}
 }
 
 void MotorController::setTarget(AXIS axis, axis_pos position, double speedMMPerSec) {
 	if (this->canMove(axis, position)) {
 		targets[axis] = position;
+		// Motors sharing the axis start together
+		IoWorker::getInstance()->holdMotion();
 		axes.at(axis)->goToTarget(position, speedMMPerSec);
+		IoWorker::getInstance()->releaseMotion();
+		this->planMotion(axis, position, speedMMPerSec);
 	}
 }
 
 void MotorController::setTarget(std::array<axis_pos, NUM_AXES> &position) {
 	if (this->canMove(position)) {
 		this->targets = position;
+		IoWorker::getInstance()->holdMotion();
 		for (Axis *axis : this->axes) {
 			axis->goToTarget(this->targets[axis->getAxis()]);
+			this->planMotion(axis->getAxis(), this->targets[axis->getAxis()], 0);
 		}
+		IoWorker::getInstance()->releaseMotion();
 	}
 }
 
 void MotorController::setTarget(std::array<axis_pos, NUM_AXES> &position, double speedMMPerSec) {
 	if (this->canMove(position)) {
 		this->targets = position;
+		IoWorker::getInstance()->holdMotion();
 		for (Axis *axis : this->axes) {
 			axis->goToTarget(this->targets[axis->getAxis()], speedMMPerSec);
+			this->planMotion(axis->getAxis(), this->targets[axis->getAxis()], speedMMPerSec);
+		}
+		IoWorker::getInstance()->releaseMotion();
+	}
+}
+
+void MotorController::setCoordinatedTarget(AXIS first, axis_pos firstPosition, AXIS second, axis_pos secondPosition) {
+	if (this->canMove(first, firstPosition) && this->canMove(second, secondPosition)) {
+		std::array<axis_pos, NUM_AXES> position = this->targets;
+		std::array<bool, NUM_AXES> moving = {{false, false, false}};
+		position[first] = firstPosition;
+		position[second] = secondPosition;
+		moving[first] = true;
+		moving[second] = true;
+		this->moveCoordinated(position, moving);
+	}
+}
+
+void MotorController::setCoordinatedTarget(const std::array<axis_pos, NUM_AXES> &position) {
+	if (this->canMove(position)) {
+		this->moveCoordinated(position, std::array<bool, NUM_AXES> {{true, true, true}});
+	}
+}
+
+void MotorController::moveCoordinated(const std::array<axis_pos, NUM_AXES> &position,
+		const std::array<bool, NUM_AXES> &moving) {
+	// The move takes as long as the slowest axis at its own limits
+	std::array<double, NUM_AXES> distance;
+	double duration = 0;
+	for (int i = 0; i < NUM_AXES; i++) {
+		distance[i] = moving[i] ? std::abs(position[i] - this->axes[i]->getCurrentPositionMM()) : 0;
+		if (distance[i] > 0 && this->axes[i]->getMaxSpeedMMPerSec() > 0) {
+			duration = std::max(duration, this->getTravelTime((AXIS) i, distance[i]));
+		}
+	}
+	// Start the axes together, or they don't arrive together
+	IoWorker::getInstance()->holdMotion();
+	for (int i = 0; i < NUM_AXES; i++) {
+		if (!moving[i]) {
+			continue;
 		}
+		this->targets[i] = position[i];
+		if (duration > 0 && distance[i] > 0) {
+			double speed = MotionProfile::getCruiseSpeedFor(distance[i], duration, this->axes[i]->getMaxSpeedMMPerSec(),
+					this->axes[i]->getAccelerationMMPerSec2(), this->axes[i]->getDecelerationMMPerSec2());
+			this->axes[i]->goToTarget(position[i], speed);
+			this->planMotion((AXIS) i, position[i], speed);
+		} else {
+			this->axes[i]->goToTarget(position[i]);
+			this->planMotion((AXIS) i, position[i], 0);
+		}
+	}
+	IoWorker::getInstance()->releaseMotion();
+}
+
+void MotorController::planMotion(AXIS axis, axis_pos position, double speedMMPerSec) {
+	double maxSpeed = this->axes[axis]->getMaxSpeedMMPerSec();
+	double speed = this->getCurrentSpeed(axis);
+	axis_pos from = this->axes[axis]->getCurrentPositionMM();
+	if (position != from) {
+		this->direction[axis] = position > from ? 1 : -1;
+	}
+	this->motion[axis].configure(speedMMPerSec > 0 ? std::min(speedMMPerSec, maxSpeed) : maxSpeed,
+			this->axes[axis]->getAccelerationMMPerSec2(), this->axes[axis]->getDecelerationMMPerSec2());
+	this->motion[axis].plan(from, speed, position);
+	this->motionStart[axis] = this->clockTicks;
+}
+
+double MotorController::getCurrentSpeed(AXIS axis) {
+	if (this->hasReachedTarget(axis)) {
+		return 0;
+	}
+	// The drivers report speed without direction, the model knows which way the axis is heading
+	double modelled = this->motion[axis].getSpeedAt(this->getMotionElapsed(axis));
+	int sign = modelled < 0 ? -1 : modelled > 0 ? 1 : this->direction[axis];
+	return sign * this->axes[axis]->getSpeedMMPerSec();
+}
+
+double MotorController::getMotionElapsed(AXIS axis) {
+	return (double) (this->clockTicks - this->motionStart[axis]) / SEC_TO_MILL;
+}
+
+double MotorController::getTimeToTarget(AXIS axis) {
+	if (this->hasReachedTarget(axis)) {
+		return 0;
+	}
+	return std::max(this->motion[axis].getDuration() - this->getMotionElapsed(axis), 0.0);
+}
+
+axis_pos MotorController::getPredictedPosition(AXIS axis, double seconds) {
+	if (this->hasReachedTarget(axis)) {
+		return this->axes[axis]->getCurrentPositionMM();
 	}
+	return round(this->motion[axis].getPositionAt(this->getMotionElapsed(axis) + seconds));
+}
+
+double MotorController::getTravelTime(AXIS axis, axis_pos distance) {
+	return MotionProfile::getTravelTime(distance, this->axes[axis]->getMaxSpeedMMPerSec(),
+			this->axes[axis]->getAccelerationMMPerSec2(), this->axes[axis]->getDecelerationMMPerSec2());
 }
 
 std::array<axis_pos, NUM_AXES> MotorController::getTarget() {
@@ -70,10 +186,21 @@ void MotorController::addAxes(const std::array<Axis *, NUM_AXES> &axes) {
 
 bool MotorController::hasReachedTarget() {
 	for (Axis *axis : this->axes) {
-		for (MotorInterface *motor : axis->getMotorObj()) {
-			if (motor && !motor->reachedTarget()) {
-				return false;
-			}
+		if (!axis->reachedTarget()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool MotorController::hasReachedTarget(AXIS axis) {
+	return this->axes[axis]->reachedTarget();
+}
+
+bool MotorController::hasReachedTargets(unsigned int axisMask) {
+	for (int i = 0; i < NUM_AXES; i++) {
+		if ((axisMask & AXIS_BIT(i)) && !this->axes[i]->reachedTarget()) {
+			return false;
 		}
 	}
 	return true;
@@ -85,6 +212,28 @@ void MotorController::zeroReturnAxis(AXIS axis, DIRECTION dir) {
 	}
 }
 
+void MotorController::approachLimitSwitch(AXIS axis, DIRECTION dir) {
+	if (ErrorHandler::getInstance()->getErrorLevel() < EL_STOP) {
+		this->axes[axis]->approachLimitSwitch(dir);
+	}
+}
+
+void MotorController::backOffLimitSwitch(AXIS axis, DIRECTION dir) {
+	if (ErrorHandler::getInstance()->getErrorLevel() < EL_STOP) {
+		this->axes[axis]->backOffLimitSwitch(dir);
+	}
+}
+
+void MotorController::moveAxisOffLimitSwitches(AXIS axis) {
+	if (ErrorHandler::getInstance()->getErrorLevel() < EL_STOP) {
+		this->axes[axis]->moveAxisOffLimitSwitches();
+	}
+}
+
+void MotorController::setAxisHomeLocation(AXIS axis) {
+	this->axes[axis]->setAxisHome();
+}
+
 // Called from Zero return control
 // Currently the motor is on the limit switch, but the home position
 // 	should exist  roughly 10mm off the switch
@@ -101,12 +250,16 @@ void MotorController::moveToStaging() {
 
 void MotorController::softStop(AXIS axis) {
 	this->axes[axis]->softStop();
+	double speed = this->getCurrentSpeed(axis);
+	this->motion[axis].planStop(this->axes[axis]->getCurrentPositionMM(), speed);
+	this->motionStart[axis] = this->clockTicks;
 }
 
 void MotorController::emergencyStop() {
 	ErrorHandler::getInstance()->emergencyStop();
 	for (Axis *axis : this->axes) {
 		axis->hardStop();
+		this->motion[axis->getAxis()].plan(axis->getCurrentPositionMM(), 0, axis->getCurrentPositionMM());
 	}
 }
 
@@ -6,6 +6,7 @@
 
 #include "../../Utilities/Axis.h"
 #include "../../Utilities/ComponentInterface.h"
+#include "../../Utilities/MotionProfile.h"
 #include "../../Hardware/PinInteractions/StatusRegister.h"
 
 
@@ -25,6 +26,10 @@ private:
 	std::array<axis_pos, NUM_AXES> targets;		/**< The current axes target */
 	std::array<Axis *, NUM_AXES> axes;			/**< An array of #Axis */
 	ERROR_LEVEL errorLevel;						/**< The current priority error level */
+	std::array<MotionProfile, NUM_AXES> motion;	/**< Model of each axis's current move, in millimeters */
+	std::array<long long int, NUM_AXES> motionStart;	/**< Clock tick each move in #motion started on */
+	std::array<int, NUM_AXES> direction;		/**< Sign of each axis's last commanded move, 1 or -1 */
+	long long int clockTicks;					/**< Clock tick of the last #step */
 
 	/**
 	 * @fn canMove(AXIS axis, axis_pos position)
@@ -50,6 +55,32 @@ private:
 	 */
 	bool canMove(const std::array<axis_pos, NUM_AXES> &proposedTarget);
 
+	/**
+	 * @fn moveCoordinated
+	 * @brief Send the @p moving axes to @p position, scaling their speeds so they arrive together.
+	 */
+	void moveCoordinated(const std::array<axis_pos, NUM_AXES> &position, const std::array<bool, NUM_AXES> &moving);
+
+	/**
+	 * @fn planMotion
+	 * @brief Model the move of @p axis to @p position, from where it is now.
+	 * @param[in] speedMMPerSec The cruise speed, the axis's fastest if not positive.
+	 */
+	void planMotion(AXIS axis, axis_pos position, double speedMMPerSec);
+
+	/**
+	 * @fn getCurrentSpeed
+	 * @return The signed speed of @p axis from the motor snapshot, in millimeters/second. Signed
+	 * 	by the modelled move, or by #direction once the model has stopped but the driver hasn't.
+	 */
+	double getCurrentSpeed(AXIS axis);
+
+	/**
+	 * @fn getMotionElapsed
+	 * @return Seconds since the move of @p axis in #motion started.
+	 */
+	double getMotionElapsed(AXIS axis);
+
 public:
 
 	/**
@@ -59,11 +90,16 @@ public:
 	 * 		- #targets : `{0, 0, 0}`
 	 * 		- #axes : \p axes
 	 * 		- #errorLevel : #EL_NO_ERROR
+	 * 		- #clockTicks : 0
 	 */
 	MotorController(const std::array<Axis *, NUM_AXES> &axes)
 		: 	targets{0, 0, 0},
 			axes(axes),
-			errorLevel(EL_NO_ERROR) {
+			errorLevel(EL_NO_ERROR),
+			motion(),
+			motionStart{0, 0, 0},
+			direction{1, 1, 1},
+			clockTicks(0) {
 	}
 	virtual ~MotorController() {}
 
@@ -88,6 +124,12 @@ public:
 	 */
 	void reportStatus(void *);
 
+	/**
+	 * @fn getStepCostUs
+	 * @brief Reading the axes positions, the motors are scheduled on their own.
+	 */
+	unsigned int getStepCostUs();
+
 	/**
 	 * @fn getPosition
 	 * @param[in] axis The desired axis.
@@ -111,6 +153,14 @@ public:
 		return axes[axis]->getStagingArea();
 	}
 
+	/**
+	 * @fn getAxes
+	 * @return The x, y, and z axes.
+	 */
+	const std::array<Axis *, NUM_AXES> &getAxes() {
+		return axes;
+	}
+
 	/**
 	 * @fn getStagingLocation
 	 * @brief Get the (x, y, z) set staging location.
@@ -171,6 +221,27 @@ public:
 	 */
 	void setTarget(AXIS axis, axis_pos position, double speedMMPerSec);
 
+	/**
+	 * @fn setCoordinatedTarget(AXIS first, axis_pos firstPosition, AXIS second, axis_pos secondPosition)
+	 * @brief Move two axes along a straight line so they arrive at the same time.
+	 *
+	 * The axis needing the longest time at its own maximum speed moves at that speed, the other
+	 * 	cruises slower so its #MotionProfile takes as long, so no axis waits at its target while
+	 * 	wasting acceleration current. Both positions must be within axis limits, else neither axis moves.
+	 * @param[in] first The first axis.
+	 * @param[in] firstPosition Its target position, in millimeters.
+	 * @param[in] second The second axis.
+	 * @param[in] secondPosition Its target position, in millimeters.
+	 */
+	void setCoordinatedTarget(AXIS first, axis_pos firstPosition, AXIS second, axis_pos secondPosition);
+
+	/**
+	 * @fn setCoordinatedTarget(const std::array<axis_pos, NUM_AXES> &position)
+	 * @brief Move every axis along a straight line to @p position, arriving at the same time.
+	 * @param[in] position The target coordinate triplet, in millimeters.
+	 */
+	void setCoordinatedTarget(const std::array<axis_pos, NUM_AXES> &position);
+
 	/**
 	 * @fn hasReachedTarget
 	 * @brief Checks if any of the axes remain in motion.
@@ -179,6 +250,52 @@ public:
 	 */
 	bool hasReachedTarget();
 
+	/**
+	 * @fn hasReachedTarget(AXIS axis)
+	 * @param[in] axis The axis.
+	 * @return Whether @p axis has reached its target location.
+	 */
+	bool hasReachedTarget(AXIS axis);
+
+	/**
+	 * @fn hasReachedTargets
+	 * @param[in] axisMask The axes, see #AXIS_BIT.
+	 * @return Whether every axis in @p axisMask has reached its target location.
+	 */
+	bool hasReachedTargets(unsigned int axisMask);
+
+	/**
+	 * @fn getMaxSpeedMMPerSec
+	 * @param[in] axis The axis.
+	 * @return The fastest speed @p axis travels, in millimeters/second.
+	 */
+	double getMaxSpeedMMPerSec(AXIS axis) {
+		return this->axes[axis]->getMaxSpeedMMPerSec();
+	}
+
+	/**
+	 * @fn getTimeToTarget
+	 * @param[in] axis The axis.
+	 * @return Seconds until @p axis reaches its target, as modelled by its #MotionProfile.
+	 */
+	double getTimeToTarget(AXIS axis);
+
+	/**
+	 * @fn getPredictedPosition
+	 * @param[in] axis The axis.
+	 * @param[in] seconds Time from now.
+	 * @return Where @p axis will be then, in millimeters, as modelled by its #MotionProfile.
+	 */
+	axis_pos getPredictedPosition(AXIS axis, double seconds);
+
+	/**
+	 * @fn getTravelTime
+	 * @param[in] axis The axis.
+	 * @param[in] distance Millimeters to travel.
+	 * @return Seconds @p axis takes to travel @p distance from a standstill at its fastest.
+	 */
+	double getTravelTime(AXIS axis, axis_pos distance);
+
 	/**
 	 * @fn addAxes
 	 * @brief Change the x, y, and z axes.
@@ -197,6 +314,39 @@ public:
 	 */
 	void zeroReturnAxis(AXIS axis, DIRECTION dir);
 
+	/**
+	 * @fn approachLimitSwitch
+	 * @brief Command an individual axis to its limit switch at its fast homing speed.
+	 *
+	 * Finds the switch quickly, #zeroReturnAxis then sets home precisely. Will check
+	 * 	that Pick-Robot has not flagged an error of priority greater than #EL_INFO.
+	 * @param[in] axis The current axis to zero.
+	 * @param[in] dir The #DIRECTION of travel
+	 */
+	void approachLimitSwitch(AXIS axis, DIRECTION dir);
+
+	/**
+	 * @fn backOffLimitSwitch
+	 * @brief Command an individual axis a few millimeters off the limit switch in direction @p dir.
+	 * @param[in] axis The current axis to zero.
+	 * @param[in] dir The #DIRECTION of the limit switch
+	 */
+	void backOffLimitSwitch(AXIS axis, DIRECTION dir);
+
+	/**
+	 * @fn moveAxisOffLimitSwitches
+	 * @brief Move an individual axis's motors off their limit switches, see #moveMotorsOffLimitSwitches.
+	 * @param[in] axis The axis.
+	 */
+	void moveAxisOffLimitSwitches(AXIS axis);
+
+	/**
+	 * @fn setAxisHomeLocation
+	 * @brief Set an individual axis's current motor location to its home location.
+	 * @param[in] axis The axis.
+	 */
+	void setAxisHomeLocation(AXIS axis);
+
 	/**
 	 * @fn softStop
 	 * @brief Issue a soft stop for a particular axis.
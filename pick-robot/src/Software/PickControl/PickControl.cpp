@@ -1,5 +1,7 @@
 #include "PickControl.h"
 
+#include <algorithm>
+
 #include "../ErrorHandler/ErrorHandler.h"
 #include "../MotorController/MotorController.h"
 #include "../TargetGeneration/TargetGenerator.h"
@@ -14,10 +16,12 @@ PickControl::PickControl(SharedMemory* sharedMemoryObj, MotorController* motorCo
 	zc = zcObj;
 	vs = vc->getSensor();
 	state = PC_NEEDS_ZERO;
-	block = {0};
 	target = {0};
 	itemsPicked = 0;
 	nextStateFunction = 0;
+	waitAxes = ALL_AXES;
+	blendMotion = false;
+	departureZ = 0;
 }
 
 PickControl::~PickControl() {
@@ -99,10 +103,16 @@ void PickControl::step(long long int clockTicks) {
 			PickControl::movingToDropoffXY();
 			break;
 		case PC_TARGET_FOUND:
+			PickControl::approachTarget();
+			break;
+		case PC_RAISING_ARM:
+			PickControl::raisingArm();
+			break;
 		case PC_MOVING_ABOVE_PICK:
+			PickControl::movingAbovePick();
+			break;
 		case PC_WAIT_FOR_MOTION:
 		case PC_MOVING_TO_DROPOFF_XYZ:
-		case PC_RAISING_ARM:
 		case PC_AT_Z_CLEARANCE_RETURN:
 			PickControl::waitForMotion();
 			break;
@@ -115,17 +125,40 @@ void PickControl::step(long long int clockTicks) {
 
 void PickControl::findTarget() {
 	tg->getNextTarget(target);
-	mc->setTarget(X, target[X]);
-	mc->setTarget(Y, target[Y]);
+	mc->setCoordinatedTarget(X, target[X], Y, target[Y]);
 	nextState = PC_AT_PICK_POSITION_XY;
 	state = PC_TARGET_FOUND;
+	waitAxes = AXIS_BIT(X) | AXIS_BIT(Y);
+}
+
+void PickControl::approachTarget() {
+	if (blendMotion && nextState == PC_AT_PICK_POSITION_XY
+			&& tg->isAboveBox(mc->getPosition(X), mc->getPosition(Y))) {
+		//The target is in the box too, so the rest of the XY move stays over the box
+		double zSeconds = mc->getTravelTime(Z, std::max(tg->getHeightAbove(mc->getPosition(Z), tg->getPileTopZ()), 0));
+		double xySeconds = std::max(mc->getTimeToTarget(X), mc->getTimeToTarget(Y));
+		if (zSeconds >= xySeconds) {
+			PickControl::moveToPickPositionZAboveItem();
+			return;
+		}
+	}
+	PickControl::waitForMotion();
 }
 
 void PickControl::moveToPickPositionZAboveItem() {
 	mc->setTarget(Z, std::min(mc->getPosition(Z), tg->getZDepthAboveItem()));
-	vc->activate();
 	nextState = PC_AT_PICK_POSITION_XY_ABOVE_Z;
 	state = PC_MOVING_ABOVE_PICK;
+	//The x and y axes may still be arriving when blending
+	waitAxes = ALL_AXES;
+}
+
+void PickControl::movingAbovePick() {
+	double arrivalSeconds = std::max(mc->getTimeToTarget(Z), std::max(mc->getTimeToTarget(X), mc->getTimeToTarget(Y)));
+	if (vc->getVacuumState() == VC_OFF && arrivalSeconds * SEC_TO_MILL <= VACUUM_LEAD_MS) {
+		vc->activate();
+	}
+	PickControl::waitForMotion();
 }
 
 void PickControl::moveToPickPositionXYZ() {
@@ -137,7 +170,7 @@ void PickControl::moveToPickPositionXYZ() {
 void PickControl::probeWithVacuum(long long int clockTicks) {
 	static long long int endTime = 0;
 	//if(hasReachedTarget() && vs->hasIndeterminateSuction()) //then we will do an optimized repick
-	if (mc->hasReachedTarget() && !vs->hasSuction()) { //&& no suction
+	if (mc->hasReachedTarget(Z) && !vs->hasSuction()) { //&& no suction
 			//Let's sleep at the bottom for some time to see if we get suction
 		endTime = endTime == 0 ? clockTicks + 0.5 * SEC_TO_MILL : endTime;
 		if (clockTicks >= endTime) {
@@ -145,6 +178,7 @@ void PickControl::probeWithVacuum(long long int clockTicks) {
 			//We reached our target without getting suction for 0.5 second
 			nextState = PC_PICK_COMMAND_RECEIVED; //Go back to finding a target
 			state = PC_WAIT_FOR_MOTION;
+			waitAxes = AXIS_BIT(Z);
 			vc->deactivate();
 			//Move back up
 			mc->setTarget(Z, tg->getZClearancePlane());
@@ -155,24 +189,44 @@ void PickControl::probeWithVacuum(long long int clockTicks) {
 		tg->markPicked(mc->getPosition(Z));
 		state = PC_WAIT_FOR_MOTION;
 		nextState = PC_HAS_ITEM;
+		waitAxes = AXIS_BIT(Z);
 	}
 }
 
 void PickControl::raiseArm() {
 	mc->setTarget(Z, tg->getZClearancePlane());
-	state = PC_WAIT_FOR_MOTION;
+	departureZ = tg->getPileClearanceZ();
+	state = PC_RAISING_ARM;
 	nextState = PC_AT_PICK_POSITION_Z_CLEARANCE;
+	waitAxes = AXIS_BIT(Z);
 	nextStateFunction = &PickControl::checkVacuumOnReturn;
 }
 
+void PickControl::raisingArm() {
+	axis_pos z = mc->getPosition(Z);
+	if (blendMotion && nextState == PC_AT_PICK_POSITION_Z_CLEARANCE && tg->getHeightAbove(z, departureZ) >= 0) {
+		//The held item has to clear the box wall before the x axis leaves the box
+		double zSeconds = mc->getTimeToTarget(Z);
+		double xSeconds = mc->getTravelTime(X, tg->getDistanceToBoxEdge(X, mc->getPosition(X), tg->getDropLocation(X)));
+		if (zSeconds <= xSeconds) {
+			state = nextState;
+			nextState = PC_READY;
+			nextStateFunction = 0;
+			PickControl::checkVacuumOnReturn();
+			return;
+		}
+	}
+	PickControl::waitForMotion();
+}
+
 void PickControl::checkVacuumOnReturn() {
 	if (!(vs->hasSuction() || vs->hasIndeterminateSuction())) {
 		mc->softStop(X);
 		mc->softStop(Y);
-		mc->setTarget(X, tg->getLastTarget(X));
-		mc->setTarget(Y, tg->getLastTarget(Y));
+		mc->setCoordinatedTarget(X, tg->getLastTarget(X), Y, tg->getLastTarget(Y));
 		state = PC_WAIT_FOR_MOTION;
 		nextState = PC_PICK_COMMAND_RECEIVED;
+		waitAxes = ALL_AXES;
 		vc->deactivate();
 	}
 }
@@ -184,6 +238,8 @@ void PickControl::deactivateGripper() {
 void PickControl::moveToDropOffPositionXY() {
 	state = PC_MOVING_TO_DROPOFF_XY;
 	nextState = PC_AT_DROPOFF_XY;
+	//Only x moves, a blended z axis may still be rising
+	waitAxes = AXIS_BIT(X);
 	nextStateFunction = &PickControl::checkVacuumOnReturn;
 	mc->setTarget(X, tg->getDropLocation(X));
 }
@@ -191,12 +247,14 @@ void PickControl::moveToDropOffPositionXY() {
 void PickControl::dropOffItem() {
 	state = PC_MOVING_TO_DROPOFF_XYZ;
 	nextState = PC_AT_DROPOFF_XYZ;
+	waitAxes = AXIS_BIT(Z);
 	mc->setTarget(Z, tg->getDropLocation(Z));
 }
 
 void PickControl::moveToDropOffPositionZHome() {
 	state = PC_AT_Z_CLEARANCE_RETURN;
 	nextState = PC_WAIT_FOR_MOTION;
+	waitAxes = AXIS_BIT(Z);
 	nextStateFunction = &PickControl::moveToStagingArea;
 	mc->setTarget(Z, tg->getZClearancePlane());
 }
@@ -205,10 +263,11 @@ void PickControl::moveToStagingArea() {
 	mc->moveToStaging();
 	state = PC_WAIT_FOR_MOTION;
 	nextState = PC_READY;
+	waitAxes = ALL_AXES;
 }
 
 void PickControl::movingToDropoffXY() {
-	if (mc->hasReachedTarget()) {
+	if (mc->hasReachedTargets(waitAxes)) {
 		state = nextState;
 		nextState = PC_READY;
 	}
@@ -218,9 +277,10 @@ void PickControl::movingToDropoffXY() {
 }
 
 void PickControl::waitForMotion() {
-	if (mc->hasReachedTarget()) {
+	if (mc->hasReachedTargets(waitAxes)) {
 		state = nextState;
 		nextState = PC_READY;
+		waitAxes = ALL_AXES;
 		if (nextStateFunction != 0) {
 			//Call the provided function
 			(this->*nextStateFunction)();
@@ -232,6 +292,7 @@ void PickControl::waitForMotion() {
 void PickControl::moveToNewDropOff() {
 	state = PC_WAIT_FOR_MOTION;
 	nextState = PC_ITEM_PLACED;
+	waitAxes = ALL_AXES;
 	nextStateFunction = &PickControl::deactivateGripper;
 }
 
@@ -244,4 +305,5 @@ void PickControl::reset() {
 	state = PC_READY;
 	nextState = PC_READY;
 	nextStateFunction = 0;
+	waitAxes = ALL_AXES;
 }
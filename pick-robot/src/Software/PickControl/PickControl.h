@@ -16,6 +16,13 @@
 #include "../../Hardware/Gripper/Interfaces/VacSensorInterface.h"
 #include "../../Utilities/ComponentInterface.h"
 #include "../../Utilities/Axis.h"
+#include "../MotorController/MotorController.h"
+
+/**
+ * @def VACUUM_LEAD_MS
+ * Milliseconds before the arm is predicted to arrive above an item that the vacuum is switched on.
+ */
+#define VACUUM_LEAD_MS 500
 
 class SharedMemory;
 
@@ -23,8 +30,6 @@ class TargetGenerator;
 
 class ZeroReturnController;
 
-class MotorController;
-
 /**
  * @class PickControl
  * @brief The controller for the pick routine, which determines appropriate motion commands.
@@ -68,8 +73,8 @@ private:
 	/** Pointer to the next function to process */
 	void (PickControl::*nextStateFunction)();
 
-	/** Passed information either from the initial configuration or Pick-Trigger-App */
-	ROBOT_IN block;
+	/** Mask of the axes #waitForMotion waits on (Default: #ALL_AXES) */
+	unsigned int waitAxes;
 
 	/** Number of items successfully picked (according to the robot's belief) */
 	long int itemsPicked;
@@ -77,6 +82,12 @@ private:
 	/** Current axis target */
 	std::array<axis_pos, NUM_AXES> target;
 
+	/** Whether Z moves overlap XY moves inside the box (Default: `false`) */
+	bool blendMotion;
+
+	/** The z axis height above which a held item may travel sideways, from #raiseArm */
+	axis_pos departureZ;
+
 	//Picking functions
 	/**
 	 * @fn findTarget
@@ -90,21 +101,44 @@ private:
 	 */
 	void findTarget();
 
+	/**
+	 * @fn approachTarget
+	 * @brief Waits for the x and y axes to reach the target.
+	 *
+	 * With #blendMotion the descent starts early, once the arm is above the box and
+	 * 	the z axis can no longer reach the top of the pile before the x and y axes arrive,
+	 * 	as predicted by the #MotorController motion model.
+	 *
+	 * **If** descending early
+	 * 		- #moveToPickPositionZAboveItem
+	 */
+	void approachTarget();
+
 	/**
 	 * @fn moveToPickPositionZAboveItem
 	 * @brief Move to ready position above target.
 	 *
 	 * Takes the minimum of the Pick-Robot z-axis current position and the
 	 * 	position above the item, commands the arm to that depth, then activates
-	 * 	the vacuum gripper.
+	 * 	the vacuum gripper through #movingAbovePick.
 	 *
 	 * Sets:
 	 * 		- #state : #PC_MOVING_ABOVE_PICK
 	 * 		- #nextState : #PC_AT_PICK_POSITION_XY_ABOVE_Z
-	 * 		- #VC_ON
 	 */
 	void moveToPickPositionZAboveItem();
 
+	/**
+	 * @fn movingAbovePick
+	 * @brief Waits for the arm to arrive above the item.
+	 *
+	 * Switches the vacuum on once the predicted arrival is within #VACUUM_LEAD_MS.
+	 *
+	 * Sets:
+	 * 		- #VC_ON
+	 */
+	void movingAbovePick();
+
 	/**
 	 * @fn moveToPickPositionXYZ
 	 * @brief Determine the target z-axis probe depth.
@@ -142,12 +176,27 @@ private:
 	 *  #VacuumSensor still has the item.
 	 *
 	 * Sets:
-	 * 		- #state : #PC_WAIT_FOR_MOTION
+	 * 		- #state : #PC_RAISING_ARM
 	 * 		- #nextState : #PC_AT_PICK_POSITION_Z_CLEARANCE
 	 * 		- #nextStateFunction : #checkVacuumOnReturn
+	 * 		- #departureZ
 	 */
 	void raiseArm();
 
+	/**
+	 * @fn raisingArm
+	 * @brief Waits for the z axis to reach the clearance height.
+	 *
+	 * With #blendMotion the arm leaves for the drop-off early, once the held item clears
+	 * 	the pile and the z axis is predicted to reach the clearance height before the x axis
+	 * 	reaches the box wall.
+	 *
+	 * **If** leaving early
+	 * 		- #state : #PC_AT_PICK_POSITION_Z_CLEARANCE
+	 * 		- #checkVacuumOnReturn
+	 */
+	void raisingArm();
+
 	/**
 	 * @checkVacuumOnReturn
 	 * @brief Checks the current state of the #VacuumSensor.
@@ -207,12 +256,13 @@ private:
 	 * @fn waitForMotion
 	 * @brief Handles motion commands by holding the current states till motors have reached their targets.
 	 *
-	 * After each motor has reached its target the #nextStateFunction is processed.
+	 * After the motors of the #waitAxes have reached their targets the #nextStateFunction is processed.
 	 *
 	 * Sets:
 	 * 		- #state : #nextState
 	 * 		- #nextState : #PC_READY
 	 * 		- #nextStateFunction : 0
+	 * 		- #waitAxes : #ALL_AXES
 	 */
 	void waitForMotion();
 
@@ -296,11 +346,12 @@ public:
 	 * @brief Set the current #PICK_STATE from outside the PickController.
 	 *
 	 * _IMPORTANT_: Be careful with how this function is used since it has the potential
-	 * 	to break the normal process flow.
+	 * 	to break the normal process flow. Waiting states wait on every axis.
 	 * @param[in] newState The desired new pick state.
 	 */
 	void setState(PICK_STATE newState) {
 		state = newState;
+		waitAxes = ALL_AXES;
 	}
 
 	/**
@@ -316,6 +367,15 @@ public:
 		nextState = newState;
 	}
 
+	/**
+	 * @fn setBlendMotion
+	 * @brief Overlap Z and XY moves inside the box's safety envelopes.
+	 * @param[in] blend From #RUNTIME_FLAGS::blendMotion.
+	 */
+	void setBlendMotion(bool blend) {
+		blendMotion = blend;
+	}
+
 	/**
 	 * @fn getState
 	 * @brief Get the current #state.
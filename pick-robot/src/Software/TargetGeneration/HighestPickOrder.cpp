@@ -0,0 +1,13 @@
+#include "HighestPickOrder.h"
+
+int HighestPickOrder::getNextCell(const PICK_GRID &grid, int) {
+	int highest = -1;
+	unsigned int cells = grid.columns * grid.rows;
+	for (unsigned int cell = 0; cell < cells; cell++) {
+		if (grid.remaining[cell] && !grid.exhausted[cell]
+				&& (highest == -1 || (grid.surface[cell] - grid.surface[highest]) * grid.up > 0)) {
+			highest = cell;
+		}
+	}
+	return highest;
+}
@@ -0,0 +1,37 @@
+#ifndef SRC_SOFTWARE_TARGETGENERATION_HIGHESTPICKORDER_H_
+#define SRC_SOFTWARE_TARGETGENERATION_HIGHESTPICKORDER_H_
+
+/**
+ * @file HighestPickOrder.h
+ */
+
+#include "PickOrderInterface.h"
+
+/**
+ * @class HighestPickOrder
+ * @brief Visits the location with the highest #PICK_GRID::surface next, across layers.
+ *
+ * Experimental. Items on top of a pile are the shortest z axis trip away. Not
+ * 	layered: a location is visited again as long as it stays the highest and its
+ * 	last probe found an item, so locations probed empty aren't probed again. On
+ * 	modelled piles that saves about a quarter of the z axis time per pick against
+ * 	#RasterPickOrder, but digging at one location lets items slide into it from
+ * 	its neighbours more often, above where the gripper slows down to probe.
+ */
+class HighestPickOrder : public PickOrderInterface {
+public:
+	virtual ~HighestPickOrder() {}
+
+	/**
+	 * @fn getNextCell
+	 * @return The highest remaining cell not #PICK_GRID::exhausted, the first in raster order among
+	 * 	equals, -1 if none is left.
+	 */
+	int getNextCell(const PICK_GRID &grid, int lastCell);
+
+	bool isLayered() {
+		return false;
+	}
+};
+
+#endif /* SRC_SOFTWARE_TARGETGENERATION_HIGHESTPICKORDER_H_ */
@@ -0,0 +1,39 @@
+#include "NearestPickOrder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "../MotorController/MotorController.h"
+
+NearestPickOrder::NearestPickOrder(MotorController *motorController) {
+	mc = motorController;
+	rowSeconds.fill(0);
+}
+
+int NearestPickOrder::getNextCell(const PICK_GRID &grid, int) {
+	axis_pos x = mc->getPosition(X);
+	axis_pos y = mc->getPosition(Y);
+	for (unsigned int row = 0; row < grid.rows; row++) {
+		rowSeconds[row] = mc->getTravelTime(Y, abs(grid.origin[Y] + (axis_pos) row * grid.pitch[Y] - y));
+	}
+	int nearest = -1;
+	double nearestSeconds = 0;
+	for (unsigned int column = 0; column < grid.columns; column++) {
+		axis_pos cellX = grid.origin[X] + (axis_pos) column * grid.pitch[X];
+		double thereSeconds = mc->getTravelTime(X, abs(cellX - x));
+		double dropSeconds = mc->getTravelTime(X, abs(grid.dropLocation[X] - cellX));
+		for (unsigned int row = 0; row < grid.rows; row++) {
+			unsigned int cell = column + row * grid.columns;
+			if (!grid.remaining[cell]) {
+				continue;
+			}
+			//The coordinated move takes as long as its slower axis, the way to the drop location only moves x
+			double seconds = std::max(thereSeconds, (double) rowSeconds[row]) + dropSeconds;
+			if (nearest == -1 || seconds < nearestSeconds || (seconds == nearestSeconds && (int) cell < nearest)) {
+				nearest = cell;
+				nearestSeconds = seconds;
+			}
+		}
+	}
+	return nearest;
+}
@@ -0,0 +1,45 @@
+#ifndef SRC_SOFTWARE_TARGETGENERATION_NEARESTPICKORDER_H_
+#define SRC_SOFTWARE_TARGETGENERATION_NEARESTPICKORDER_H_
+
+/**
+ * @file NearestPickOrder.h
+ */
+
+#include <array>
+
+#include "PickOrderInterface.h"
+
+class MotorController;
+
+/**
+ * @class NearestPickOrder
+ * @brief Visits the remaining location the gripper gets to and back to the drop location soonest.
+ *
+ * A location costs the coordinated (x, y) move to it from where the gripper is now,
+ * 	plus the x axis move on to #PICK_GRID::dropLocation, both timed with
+ * 	MotorController::getTravelTime. Travel times only depend on the column or the
+ * 	row, so each is worked out once per decision rather than once per location.
+ * 	Ties go to the earlier location in raster order.
+ */
+class NearestPickOrder : public PickOrderInterface {
+private:
+	/** Positions and travel times of the axes */
+	MotorController *mc;
+	/** Seconds the y axis takes to reach each row, rebuilt by every #getNextCell */
+	std::array<float, MAX_GRID_CELLS> rowSeconds;
+
+public:
+	/**
+	 * @param[in] motorController Positions and travel times of the axes.
+	 */
+	NearestPickOrder(MotorController *motorController);
+	virtual ~NearestPickOrder() {}
+
+	/**
+	 * @fn getNextCell
+	 * @return The remaining cell with the shortest round trip, -1 if none is left.
+	 */
+	int getNextCell(const PICK_GRID &grid, int lastCell);
+};
+
+#endif /* SRC_SOFTWARE_TARGETGENERATION_NEARESTPICKORDER_H_ */
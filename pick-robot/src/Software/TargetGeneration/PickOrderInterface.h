@@ -0,0 +1,72 @@
+#ifndef SRC_SOFTWARE_TARGETGENERATION_PICKORDERINTERFACE_H_
+#define SRC_SOFTWARE_TARGETGENERATION_PICKORDERINTERFACE_H_
+
+/**
+ * @file PickOrderInterface.h
+ */
+
+#include <ConfigStruct.h>
+#include <array>
+#include <bitset>
+
+#include "../../Hardware/Motors/MotorInterface.h"
+#include "../../Utilities/Axis.h"
+
+/**
+ * @def MAX_GRID_CELLS
+ * @brief Locations a box grid can hold.
+ *
+ * The whole travel of the big machine at 10 mm items fits. Larger boxes are only
+ * 	picked as far as the grid reaches.
+ */
+#define MAX_GRID_CELLS 4096U
+
+/**
+ * @typedef PICK_GRID
+ * @brief The (x, y) locations of the current layer of a box.
+ *
+ * Cells are numbered row by row, cell `column + row * columns` lies at
+ * 	`(origin[X] + column * pitch[X], origin[Y] + row * pitch[Y])`.
+ */
+typedef struct {
+	unsigned int columns;					/**< Locations along the x axis */
+	unsigned int rows;						/**< Locations along the y axis */
+	axis_pos origin[2];						/**< The (x, y) position of cell 0 */
+	axis_pos pitch[2];						/**< Signed distance between neighbouring cells along x and y */
+	axis_pos dropLocation[NUM_AXES];		/**< Where every pick is carried to */
+	int up;									/**< The sign of z axis travel out of the box */
+	std::bitset<MAX_GRID_CELLS> remaining;	/**< Cells not known to be empty, and not yet visited in this layer if layered */
+	std::array<axis_pos, MAX_GRID_CELLS> surface;	/**< Estimated z axis position of the top of the pile in each cell */
+	std::bitset<MAX_GRID_CELLS> exhausted;	/**< Cells whose last probe found nothing, probing again from the same pick height won't either */
+} PICK_GRID;
+
+/**
+ * @class PickOrderInterface
+ * @brief Decides which location of the box the Pick-Robot visits next.
+ *
+ * A layered order chooses among the locations of the current layer that are left,
+ * 	and the #TargetGenerator works through the box layer by layer. Otherwise every
+ * 	location not known to be empty is offered each time, until none is left.
+ */
+class PickOrderInterface {
+public:
+	virtual ~PickOrderInterface() {}
+
+	/**
+	 * @fn getNextCell
+	 * @param[in] grid The current layer.
+	 * @param[in] lastCell The cell visited last, -1 at the start of a layer.
+	 * @return One of the #PICK_GRID::remaining cells, -1 if none is left.
+	 */
+	virtual int getNextCell(const PICK_GRID &grid, int lastCell) = 0;
+
+	/**
+	 * @fn isLayered
+	 * @return Whether each location is visited once per layer.
+	 */
+	virtual bool isLayered() {
+		return true;
+	}
+};
+
+#endif /* SRC_SOFTWARE_TARGETGENERATION_PICKORDERINTERFACE_H_ */
@@ -0,0 +1,11 @@
+#include "RasterPickOrder.h"
+
+int RasterPickOrder::getNextCell(const PICK_GRID &grid, int lastCell) {
+	unsigned int cells = grid.columns * grid.rows;
+	for (unsigned int cell = lastCell + 1; cell < cells; cell++) {
+		if (grid.remaining[cell]) {
+			return cell;
+		}
+	}
+	return -1;
+}
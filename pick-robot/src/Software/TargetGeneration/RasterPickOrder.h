@@ -0,0 +1,25 @@
+#ifndef SRC_SOFTWARE_TARGETGENERATION_RASTERPICKORDER_H_
+#define SRC_SOFTWARE_TARGETGENERATION_RASTERPICKORDER_H_
+
+/**
+ * @file RasterPickOrder.h
+ */
+
+#include "PickOrderInterface.h"
+
+/**
+ * @class RasterPickOrder
+ * @brief Visits a layer row by row, along the x axis first, from #TARGET_GENERATOR_CONFIG::boxStart.
+ */
+class RasterPickOrder : public PickOrderInterface {
+public:
+	virtual ~RasterPickOrder() {}
+
+	/**
+	 * @fn getNextCell
+	 * @return The first remaining cell after @p lastCell, -1 if none is left.
+	 */
+	int getNextCell(const PICK_GRID &grid, int lastCell);
+};
+
+#endif /* SRC_SOFTWARE_TARGETGENERATION_RASTERPICKORDER_H_ */
@@ -1,6 +1,7 @@
 #include "TargetGenerator.h"
 
 #include <algorithm>
+#include <cmath>
 #include <string.h>
 
 inline int sign(int x) {
@@ -11,7 +12,15 @@ inline int sign(int x) {
 TargetGenerator::TargetGenerator(TARGET_GENERATOR_CONFIG* tgConfig) {
 	xIndex = 0;
 	yIndex = 0;
+	grid.columns = 0;
+	grid.rows = 0;
+	pileTop = 0;
+	pileTopStale = true;
+	visits = 0;
 	firstTarget = true;
+	pickOrders.fill(NULL);
+	pickOrders[PO_RASTER] = &raster;
+	pickOrder = PO_RASTER;
 	this->updateConfig(tgConfig);
 	newBoxAdded();
 }
@@ -20,6 +29,99 @@ void TargetGenerator::updateConfig(TARGET_GENERATOR_CONFIG* tgConfig) {
 	this->setDeltas(tgConfig->delta);
 	this->setBoxDimensions(tgConfig->boxStart, tgConfig->boxEnd);
 	this->setDropLocation(tgConfig->dropLocation);
+	this->sizeGrid();
+	pickOrder = tgConfig->pickOrder;
+}
+
+void TargetGenerator::sizeGrid() {
+	unsigned int newColumns = 1;
+	unsigned int newRows = 1;
+	// One location per item, the last one short of boxEnd
+	if (delta[X] > 0) {
+		newColumns = std::max((unsigned int) (abs(boxEnd[X] - boxStart[X]) + delta[X] - 1) / delta[X], 1U);
+	}
+	if (delta[Y] > 0) {
+		newRows = std::max((unsigned int) (abs(boxEnd[Y] - boxStart[Y]) + delta[Y] - 1) / delta[Y], 1U);
+	}
+	newColumns = std::min(newColumns, MAX_GRID_CELLS);
+	newRows = std::min(newRows, MAX_GRID_CELLS / newColumns);
+	if (newColumns != grid.columns || newRows != grid.rows) {
+		grid.columns = newColumns;
+		grid.rows = newRows;
+		std::fill_n(lastPickHeight.begin(), grid.columns * grid.rows, 0);
+		grid.exhausted.reset();
+	}
+	for (int i = X; i <= Y; i++) {
+		grid.origin[i] = boxStart[i];
+		grid.pitch[i] = delta[i] * deltaDir[i];
+	}
+	memcpy((void *) grid.dropLocation, (void *) dropLocation, sizeof(axis_pos) * NUM_AXES);
+	grid.up = -deltaDir[Z];
+	for (unsigned int cell = 0; cell < grid.columns * grid.rows; cell++) {
+		if (lastPickHeight[cell] == 0) {
+			estimateSurface(cell);
+		}
+	}
+	pileTopStale = true;
+}
+
+void TargetGenerator::estimateSurface(unsigned int cell) {
+	int column = cell % grid.columns;
+	int row = cell / grid.columns;
+	long weightedSum = 0;
+	int weights = 0;
+	for (int r = std::max(row - 1, 0); r <= std::min(row + 1, (int) grid.rows - 1); r++) {
+		for (int c = std::max(column - 1, 0); c <= std::min(column + 1, (int) grid.columns - 1); c++) {
+			unsigned int neighbour = c + r * grid.columns;
+			if (neighbour != cell && lastPickHeight[neighbour] != 0) {
+				int weight = (r == row || c == column) ? 2 : 1;
+				weightedSum += (long) grid.surface[neighbour] * weight;
+				weights += weight;
+			}
+		}
+	}
+	grid.surface[cell] = weights > 0 ? (axis_pos) round((double) weightedSum / weights) : getTopOfBoxZ();
+}
+
+void TargetGenerator::setSurface(unsigned int cell, axis_pos z) {
+	grid.surface[cell] = z;
+	int column = cell % grid.columns;
+	int row = cell / grid.columns;
+	for (int r = std::max(row - 1, 0); r <= std::min(row + 1, (int) grid.rows - 1); r++) {
+		for (int c = std::max(column - 1, 0); c <= std::min(column + 1, (int) grid.columns - 1); c++) {
+			if (lastPickHeight[c + r * grid.columns] == 0) {
+				estimateSurface(c + r * grid.columns);
+			}
+		}
+	}
+}
+
+void TargetGenerator::setPickHeight(unsigned int cell, axis_pos z) {
+	lastPickHeight[cell] = z;
+	pileTopStale = true;
+	grid.exhausted.reset(cell);
+	setSurface(cell, z);
+}
+
+void TargetGenerator::startLayer() {
+	grid.remaining.reset();
+	for (unsigned int cell = 0; cell < grid.columns * grid.rows; cell++) {
+		if (lastPickHeight[cell] != boxEnd[Z]) {
+			grid.remaining.set(cell);
+		}
+	}
+}
+
+unsigned int TargetGenerator::getCapacity() {
+	unsigned int layers = delta[Z] > 0 ? (abs(boxEnd[Z] - boxStart[Z]) + delta[Z] - 1) / delta[Z] : 1;
+	return grid.columns * grid.rows * std::max(layers, 1U);
+}
+
+PickOrderInterface *TargetGenerator::getPickOrder() {
+	if (pickOrder >= 0 && pickOrder < NUM_PICK_ORDERS && pickOrders[pickOrder] != NULL) {
+		return pickOrders[pickOrder];
+	}
+	return &raster;
 }
 
 TargetGenerator::~TargetGenerator() {
@@ -34,40 +136,43 @@ void TargetGenerator::getNextTarget(std::array<axis_pos, NUM_AXES> &targetOut) {
 		return;
 	}
 
-	if (firstTarget) {
+	int lastCell = getCell();
+	PickOrderInterface *order = getPickOrder();
+	if (firstTarget || !order->isLayered()) {
 		firstTarget = false;
-		targetOut = lastPick;
-		return;
+		startLayer();
+		lastCell = -1;
 	}
 
-	do {
-		xIndex = std::min(xIndex + 1U, MAX_GRID_SIZE);
-		lastPick[X] += delta[X] * deltaDir[X];
-
-		if (sign(boxEnd[X] - lastPick[X]) != deltaDir[X]) {
-			xIndex = 0;
-			lastPick[X] = boxStart[X];
-			yIndex = std::min(yIndex + 1U, MAX_GRID_SIZE);
-			lastPick[Y] += delta[Y] * deltaDir[Y];
-			if (sign(boxEnd[Y] - lastPick[Y]) != deltaDir[Y]) {
-				yIndex = 0;
-				lastPick[Y] = boxStart[Y];
-				lastPick[Z] += delta[Z] * deltaDir[Z];
-				needNewBox = (sign(boxEnd[Z] - lastPick[Z]) != deltaDir[Z]);
-			}
-		}
-		if (!needNewBox) {
-			targetOut = lastPick;
-		} else {
+	//Without layers, stop once no location is left or after as many visits as layers would make
+	int cell = order->isLayered() || visits < getCapacity() ? order->getNextCell(grid, lastCell) : -1;
+	while (cell == -1) {
+		//Layer done, go one item deeper
+		lastPick[Z] += delta[Z] * deltaDir[Z];
+		needNewBox = !order->isLayered() || delta[Z] == 0 || (sign(boxEnd[Z] - lastPick[Z]) != deltaDir[Z]);
+		if (needNewBox) {
 			xIndex = 0;
 			yIndex = 0;
-			break;
+			return;
 		}
-	} while (!needNewBox && lastPickHeight[xIndex][yIndex] == boxEnd[Z]);
+		startLayer();
+		cell = order->getNextCell(grid, -1);
+	}
+	grid.remaining.reset(cell);
+	visits++;
+	xIndex = cell % grid.columns;
+	yIndex = cell / grid.columns;
+	lastPick[X] = grid.origin[X] + (axis_pos) xIndex * grid.pitch[X];
+	lastPick[Y] = grid.origin[Y] + (axis_pos) yIndex * grid.pitch[Y];
+	targetOut = lastPick;
 }
 
 void TargetGenerator::newBoxAdded() {
-	memset(lastPickHeight, 0, sizeof(axis_pos) * MAX_GRID_SIZE * MAX_GRID_SIZE);
+	std::fill_n(lastPickHeight.begin(), grid.columns * grid.rows, 0);
+	std::fill_n(grid.surface.begin(), grid.columns * grid.rows, getTopOfBoxZ());
+	grid.exhausted.reset();
+	pileTopStale = true;
+	visits = 0;
 	reset();
 	needNewBox = false;
 }
@@ -77,10 +182,10 @@ void TargetGenerator::getLastTarget(std::array<axis_pos, NUM_AXES> &targetOut) {
 }
 
 axis_pos TargetGenerator::getZDepthAboveItem() {
-	if (lastPickHeight[xIndex][yIndex] == 0) {
+	if (lastPickHeight[getCell()] == 0) {
 		return std::min(0, this->lastPick[Z] - (deltaDir[Z] * 20));
 	} else {
-		axis_pos zAboveItem = lastPickHeight[xIndex][yIndex]
+		axis_pos zAboveItem = lastPickHeight[getCell()]
 				+ (deltaDir[Z] * getSmallestDimensionOfDelta());
 		if (deltaDir[Z] > 0) {
 			return std::min(boxEnd[Z], zAboveItem);
@@ -110,25 +215,80 @@ axis_pos TargetGenerator::getZClearancePlane() {
 	return std::min(clearancePlane, 0);
 }
 
+axis_pos TargetGenerator::getPileTopZ() {
+	if (delta[X] <= 0 || delta[Y] <= 0) {
+		return getTopOfBoxZ();
+	}
+	if (!pileTopStale) {
+		return pileTop;
+	}
+	pileTopStale = false;
+	pileTop = boxEnd[Z];
+	for (unsigned int cell = 0; cell < grid.columns * grid.rows; cell++) {
+		if (lastPickHeight[cell] == 0) {
+			//Never probed, it could be full to the top
+			pileTop = getTopOfBoxZ();
+			break;
+		}
+		//Whatever is left at a location lies below where its last item was found
+		if (getHeightAbove(lastPickHeight[cell], pileTop) > 0) {
+			pileTop = lastPickHeight[cell];
+		}
+	}
+	return pileTop;
+}
+
+axis_pos TargetGenerator::getPileClearanceZ() {
+	//Same allowance as getZClearancePlane for an item hanging from the gripper
+	int largestDimension = getLargestDimensionOfDelta() * 1.414;
+	axis_pos pileClearance = getPileTopZ() + (-deltaDir[Z] * largestDimension) + (-deltaDir[Z] * 20);
+	axis_pos clearancePlane = getZClearancePlane();
+	return getHeightAbove(pileClearance, clearancePlane) > 0 ? clearancePlane : pileClearance;
+}
+
+axis_pos TargetGenerator::getHeightAbove(axis_pos z, axis_pos reference) {
+	return (z - reference) * -deltaDir[Z];
+}
+
+bool TargetGenerator::isAboveBox(axis_pos x, axis_pos y) {
+	return x >= std::min(boxStart[X], boxEnd[X]) && x <= std::max(boxStart[X], boxEnd[X])
+			&& y >= std::min(boxStart[Y], boxEnd[Y]) && y <= std::max(boxStart[Y], boxEnd[Y]);
+}
+
+axis_pos TargetGenerator::getDistanceToBoxEdge(AXIS axis, axis_pos from, axis_pos toward) {
+	axis_pos low = std::min(boxStart[axis], boxEnd[axis]);
+	axis_pos high = std::max(boxStart[axis], boxEnd[axis]);
+	if (from < low || from > high) {
+		return 0;
+	}
+	return toward < from ? from - low : high - from;
+}
+
 bool TargetGenerator::isLastPickHeightSet() {
-	return lastPickHeight[xIndex][yIndex] == 0;
+	return lastPickHeight[getCell()] == 0;
 }
 
 axis_pos TargetGenerator::getZProbeDepth() {
-	if (lastPickHeight[xIndex][yIndex] == 0) {
+	unsigned int cell = getCell();
+	if (lastPickHeight[cell] == 0) {
 		//Set to the bottom, assuming we fail
-		lastPickHeight[xIndex][yIndex] = boxEnd[Z];
+		setPickHeight(cell, boxEnd[Z]);
+		grid.exhausted.set(cell);
 		return boxEnd[Z];
-	} else if (lastPickHeight[xIndex][yIndex] == boxEnd[Z]) {
+	} else if (lastPickHeight[cell] == boxEnd[Z]) {
 		return getZClearancePlane() - 1; //Skip this, shouldn't even hit this line of code
 	} else {
-		axis_pos nextStop = lastPickHeight[xIndex][yIndex]
+		axis_pos nextStop = lastPickHeight[cell]
 				+ getLargestDimensionOfDelta() * deltaDir[Z];
 		if (deltaDir[Z] == -1) {
-			return std::max(nextStop, boxEnd[Z]);
+			nextStop = std::max(nextStop, boxEnd[Z]);
 		} else {
-			return std::min(nextStop, boxEnd[Z]);
+			nextStop = std::min(nextStop, boxEnd[Z]);
 		}
+		//Assuming we fail, nothing is left above where this stops
+		setSurface(cell, nextStop);
+		grid.exhausted.set(cell);
+		return nextStop;
 	}
 }
 
@@ -137,7 +297,7 @@ axis_pos TargetGenerator::getTopOfBoxZ() {
 }
 
 void TargetGenerator::markPicked(axis_pos zPos) {
-	lastPickHeight[abs(xIndex)][abs(yIndex)] = zPos;
+	setPickHeight(getCell(), zPos);
 }
 
 //This does not follow the normal flow of target generation, be careful with this
@@ -12,12 +12,8 @@
 
 #include "../../Hardware/Motors/MotorInterface.h"
 #include "../../Utilities/Axis.h"
-
-/**
- * @def MAX_GRID_SIZE
- *
- */
-#define MAX_GRID_SIZE 500U
+#include "PickOrderInterface.h"
+#include "RasterPickOrder.h"
 
 /**
  * @class TargetGenerator
@@ -26,8 +22,10 @@
  *
  * Dynamically creates a grid of target locations within the predefined
  * 	box limits. The Pick-Robot generates targets based on the package size
- * 	in a 3D plane such that targets will be processed in a raster pattern, until
- * 	each target has been achieved. When there are no longer targets to process,
+ * 	in a 3D plane such that targets will be processed layer by layer, in the order
+ * 	chosen by a #PickOrderInterface (a raster pattern by default), until
+ * 	each target has been achieved. Orders that aren't layered choose among every
+ * 	location not known to be empty instead. When there are no longer targets to process,
  * 	a new box flag is set to indicate that the robot's belief suggests that
  * 	the current RPC is empty. All successful picks at a given (x, y) location, will
  * 	record pick depth. This allows faster picking the next time the (x, y) target
@@ -74,9 +72,45 @@ private:
 	axis_pos dropLocation[NUM_AXES];
 
 	/**
-	 * Last pick height for each location
+	 * Last pick height for each location, 0 if never probed. Only the first
+	 * 	#PICK_GRID::columns * #PICK_GRID::rows are in use, indexed by cell.
+	 */
+	std::array<axis_pos, MAX_GRID_CELLS> lastPickHeight;
+
+	/**
+	 * The last #getPileTopZ, only recomputed once #pileTopStale.
+	 */
+	axis_pos pileTop;
+
+	/**
+	 * Whether #lastPickHeight changed since #pileTop was computed.
+	 */
+	bool pileTopStale;
+
+	/**
+	 * Targets given out from the current box.
+	 */
+	unsigned int visits;
+
+	/**
+	 * The locations of the box, and those left in the current layer.
+	 */
+	PICK_GRID grid;
+
+	/**
+	 * The default pick order.
 	 */
-	axis_pos lastPickHeight[MAX_GRID_SIZE][MAX_GRID_SIZE];
+	RasterPickOrder raster;
+
+	/**
+	 * The available pick orders, indexed by #PICK_ORDER, NULL if not available.
+	 */
+	std::array<PickOrderInterface *, NUM_PICK_ORDERS> pickOrders;
+
+	/**
+	 * The configured #PICK_ORDER.
+	 */
+	int pickOrder;
 
 	/**
 	 * Index of the x axis.
@@ -92,6 +126,64 @@ private:
 	 * The first generated pick location.
 	 */
 	bool firstTarget;
+
+	/**
+	 * @fn sizeGrid
+	 * @brief Lay #grid out over the box, a location every item size.
+	 *
+	 * Forgets every pick height if the grid changed shape.
+	 */
+	void sizeGrid();
+
+	/**
+	 * @fn estimateSurface
+	 * @brief Interpolate #PICK_GRID::surface of @p cell, a cell never probed.
+	 *
+	 * The weighted mean of the surface of its probed neighbours, those sharing an
+	 * 	edge counting twice those sharing a corner. Full to the top of the box if
+	 * 	none of them was probed.
+	 */
+	void estimateSurface(unsigned int cell);
+
+	/**
+	 * @fn setSurface
+	 * @brief Set #PICK_GRID::surface of the probed @p cell to @p z and interpolate the cells
+	 * 	around it never probed.
+	 */
+	void setSurface(unsigned int cell, axis_pos z);
+
+	/**
+	 * @fn setPickHeight
+	 * @brief Record @p z as the pick height of @p cell and update the surface around it.
+	 */
+	void setPickHeight(unsigned int cell, axis_pos z);
+
+	/**
+	 * @fn startLayer
+	 * @brief Make every location not known to be empty remaining again.
+	 */
+	void startLayer();
+
+	/**
+	 * @fn getCapacity
+	 * @return The most items the box holds, one per location and layer. Layered orders
+	 * 	give out this many targets per box, and orders that aren't stop there too.
+	 */
+	unsigned int getCapacity();
+
+	/**
+	 * @fn getCell
+	 * @return The #lastPickHeight index of the current (x, y) location.
+	 */
+	unsigned int getCell() {
+		return yIndex * grid.columns + xIndex;
+	}
+
+	/**
+	 * @fn getPickOrder
+	 * @return The configured pick order, the raster if it isn't available.
+	 */
+	PickOrderInterface *getPickOrder();
 public:
 	/**
 	 * @param[in] targetGeneratorConfig Passed items size, box dimensions, and drop location.
@@ -106,12 +198,24 @@ public:
 
 	/**
 	 * @fn updateConfig
-	 * @brief Updates #delta, box dimensions, and #dropLocation.
+	 * @brief Updates #delta, box dimensions, #dropLocation and #pickOrder.
 	 * @param[in] tgConfig A reference to the new box dimensions, delta, and
 	 * 	drop location values.
 	 */
 	void updateConfig(TARGET_GENERATOR_CONFIG* tgConfig);
 
+	/**
+	 * @fn setPickOrder
+	 * @brief Make @p order available as #PICK_ORDER @p index.
+	 *
+	 * The raster is always available as #PO_RASTER.
+	 * @param[in] index The #PICK_ORDER configurations select @p order by.
+	 * @param[in] order The pick order, not owned.
+	 */
+	void setPickOrder(PICK_ORDER index, PickOrderInterface *order) {
+		pickOrders[index] = order;
+	}
+
 	/**
 	 * @fn setDeltas
 	 * @brief Generates the relative distance between each picking target.
@@ -161,13 +265,15 @@ public:
 	 * @fn reset
 	 * @brief Reset the target generation system.
 	 *
-	 * Transitions #lastPick to the #boxStart, sets #firstTarget to true,
-	 * 	and indicates that a new box is not needed.
+	 * Transitions #lastPick to the #boxStart, along with #xIndex and #yIndex,
+	 * 	sets #firstTarget to true, and indicates that a new box is not needed.
 	 */
 	void reset() {
 		for (int i = X; i <= Z; i++) {
 			lastPick[i] = boxStart[i];
 		}
+		xIndex = 0;
+		yIndex = 0;
 		firstTarget = true;
 		needNewBox = false;
 	}
@@ -178,7 +284,8 @@ public:
 	 *
 	 * If a new box is _not_requried, generate a target that exists within
 	 * 	the pre-determined box dimensions, such that previously picked (x, y) target
-	 * 	locations exist at a shallower depth.
+	 * 	locations exist at a shallower depth. Locations known to be empty are skipped,
+	 * 	the others are visited once per layer in the configured pick order.
 	 * 	@param[out] targetOut A reference to the next target.
 	 */
 	void getNextTarget(std::array<axis_pos, NUM_AXES> &targetOut);
@@ -239,6 +346,49 @@ public:
 	 */
 	axis_pos getZClearancePlane();
 
+	/**
+	 * @fn getPileTopZ
+	 * @brief The highest any item left in the box can reach.
+	 *
+	 * Until every location has been probed this is the top of the box. Kept
+	 * 	between changes to #lastPickHeight, so it is cheap to call every tick.
+	 * @return The z axis position of the top of the pile.
+	 */
+	axis_pos getPileTopZ();
+
+	/**
+	 * @fn getPileClearanceZ
+	 * @brief The z axis height at which an item held by the gripper clears the pile.
+	 * @return The lower of #getZClearancePlane and the pile top plus a hanging item.
+	 */
+	axis_pos getPileClearanceZ();
+
+	/**
+	 * @fn getHeightAbove
+	 * @param[in] z A z axis position.
+	 * @param[in] reference Another z axis position.
+	 * @return How far @p z is above @p reference in millimeters, negative if below.
+	 */
+	axis_pos getHeightAbove(axis_pos z, axis_pos reference);
+
+	/**
+	 * @fn isAboveBox
+	 * @param[in] x The x axis position.
+	 * @param[in] y The y axis position.
+	 * @return Whether (x, y) is within the picking region of the box.
+	 */
+	bool isAboveBox(axis_pos x, axis_pos y);
+
+	/**
+	 * @fn getDistanceToBoxEdge
+	 * @brief Distance left inside the picking region when travelling along @p axis.
+	 * @param[in] axis The axis of travel.
+	 * @param[in] from The current position.
+	 * @param[in] toward The destination.
+	 * @return Millimeters until the edge of the picking region toward @p toward, 0 if already outside.
+	 */
+	axis_pos getDistanceToBoxEdge(AXIS axis, axis_pos from, axis_pos toward);
+
 	/**
 	 * @fn getDropLocation
 	 * @return The drop location for a specific axis.
@@ -273,6 +423,10 @@ public:
 	 * @fn getZProbeDepth
 	 * @brief The minimum depth between the previous pick, at the current (x, y) location, and
 	 * 	the bottom of the box.
+	 *
+	 * The probe doesn't change where the next one starts. Assuming it fails, nothing
+	 * 	is left above where it stops, which lowers #PICK_GRID::surface and marks the
+	 * 	location #PICK_GRID::exhausted until #markPicked says otherwise.
 	 * @return The probing depth.
 	 */
 	axis_pos getZProbeDepth();
@@ -7,9 +7,7 @@
 
 #include "ZeroReturnController.h"
 
-#include <SharedMemoryStructs.h>
-
-#include "../../Utilities/Axis.h"
+#include "../../Utilities/PositionSnapshot.h"
 #include "../ErrorHandler/ErrorHandler.h"
 #include "../MotorController/MotorController.h"
 
@@ -17,12 +15,21 @@ ZeroReturnController::ZeroReturnController(MotorController *mcObj) {
 	mc = mcObj;
 	state = ZR_IDLE;
 	zeroed = false;
+	for (int i = 0; i < NUM_AXES; i++) {
+		phases[i] = HP_WAITING;
+	}
+	clockTicks = 0;
+	startedAt = -1;
+	finishedAt = -1;
+	snapshot = NULL;
+	geometry = 0;
 }
 
 ZeroReturnController::~ZeroReturnController() {
 }
 
 void ZeroReturnController::step(long long int clockTicks) {
+	this->clockTicks = clockTicks;
 	ERROR_LEVEL currLevel = ErrorHandler::getInstance()->getErrorLevel();
 	if (currLevel >= EL_STOP_AND_ZERO) {
 		this->state = ZR_IDLE;
@@ -32,22 +39,12 @@ void ZeroReturnController::step(long long int clockTicks) {
 	case ZR_IDLE:
 		break;
 	case ZR_STARTED:
+		this->startedAt = clockTicks;
+		this->finishedAt = -1;
 		this->zeroReturnAxisZ();
 		break;
-	case ZR_ZEROING_Z:
-		this->checkLimitSwitchZ();
-		break;
-	case ZR_AT_Z_ZERO:
-		this->zeroReturnAxesXY();
-		break;
-	case ZR_ZEROING_XY:
-		this->checkLimitSwitchXY();
-		break;
-	case ZR_MOVE_OFF_LIM_SWITCH:
-		this->moveToOffset();
-		break;
-	case ZR_MOVING_OFF_SWITCH:
-		this->waitUntilAtOffset();
+	case ZR_HOMING:
+		this->homeAxes();
 		break;
 	case ZR_AT_ZERO:
 		this->moveToStaging();
@@ -55,61 +52,92 @@ void ZeroReturnController::step(long long int clockTicks) {
 	case ZR_MOVING_TO_STAGING:
 		this->waitUntilAtStaging();
 	}
+	if (snapshot != NULL) {
+		snapshot->write(mc->getAxes(), geometry, zeroed, mc->hasReachedTarget());
+	}
 }
 
-void ZeroReturnController::zeroReturnAxisZ() {
-	mc->zeroReturnAxis(Z, DIRECTION::DIR_FORWARD);
-	state = ZR_ZEROING_Z;
+bool ZeroReturnController::restore(PositionSnapshot *snapshot, uint32_t geometry) {
+	this->snapshot = snapshot;
+	this->geometry = geometry;
+	if (state == ZR_IDLE && snapshot->canResume(mc->getAxes(), geometry)) {
+		zeroed = true;
+	}
+	return zeroed;
 }
 
-void ZeroReturnController::zeroReturnAxesXY() {
-	mc->zeroReturnAxis(X, DIRECTION::DIR_BACKWARD);
-	mc->zeroReturnAxis(Y, DIRECTION::DIR_BACKWARD);
-	state = ZR_ZEROING_XY;
+DIRECTION ZeroReturnController::getHomingDirection(AXIS axis) {
+	return axis == Z ? DIRECTION::DIR_FORWARD : DIRECTION::DIR_BACKWARD;
 }
 
-void ZeroReturnController::checkLimitSwitchZ() {
-	if (mc->hasReachedTarget()) {
-		state = ZR_AT_Z_ZERO;
+void ZeroReturnController::zeroReturnAxisZ() {
+	for (int i = 0; i < NUM_AXES; i++) {
+		phases[i] = HP_WAITING;
 	}
+	mc->approachLimitSwitch(Z, getHomingDirection(Z));
+	phases[Z] = HP_APPROACHING;
+	state = ZR_HOMING;
 }
 
-void ZeroReturnController::checkLimitSwitchXY() {
-	if (mc->hasReachedTarget()) {
-		state = ZR_MOVE_OFF_LIM_SWITCH;
+void ZeroReturnController::homeAxes() {
+	bool homed = true;
+	for (int i = 0; i < NUM_AXES; i++) {
+		this->homeAxis((AXIS) i);
+		homed = homed && phases[i] == HP_HOMED;
 	}
-}
-
-void ZeroReturnController::moveToOffset() {
-	mc->moveMotorsOffLimitSwitches();
-	state = ZR_MOVING_OFF_SWITCH;
-}
-
-void ZeroReturnController::waitUntilAtOffset() {
-	if (mc->hasReachedTarget()) {
-		mc->setMotorHomeLocation();
+	if (homed) {
 		zeroed = true;
 		state = ZR_AT_ZERO;
 	}
 }
 
+void ZeroReturnController::homeAxis(AXIS axis) {
+	DIRECTION dir = getHomingDirection(axis);
+	if (phases[axis] == HP_WAITING) {
+		// The arm is clear of the box once z has found its switch
+		if (phases[Z] > HP_APPROACHING) {
+			mc->approachLimitSwitch(axis, dir);
+			phases[axis] = HP_APPROACHING;
+		}
+		return;
+	}
+	if (phases[axis] == HP_HOMED || !mc->hasReachedTarget(axis)) {
+		return;
+	}
+	switch (phases[axis]) {
+	case HP_APPROACHING:
+		mc->backOffLimitSwitch(axis, dir);
+		phases[axis] = HP_BACKING_OFF;
+		break;
+	case HP_BACKING_OFF:
+		mc->zeroReturnAxis(axis, dir);
+		phases[axis] = HP_ZEROING;
+		break;
+	case HP_ZEROING:
+		mc->moveAxisOffLimitSwitches(axis);
+		phases[axis] = HP_MOVING_OFF_SWITCH;
+		break;
+	case HP_MOVING_OFF_SWITCH:
+		mc->setAxisHomeLocation(axis);
+		phases[axis] = HP_HOMED;
+		break;
+	default:
+		break;
+	}
+}
+
 void ZeroReturnController::moveToStaging() {
-	mc->moveToStaging();
-	state = ZR_MOVING_TO_STAGING;
+	// Plan from the home positions, not the positions before they were set
+	if (mc->hasReachedTarget()) {
+		mc->moveToStaging();
+		state = ZR_MOVING_TO_STAGING;
+	}
 }
 
 void ZeroReturnController::waitUntilAtStaging() {
-	static bool once = false;
-	if (!once) {
-		if (mc->hasReachedTarget()) {
-			once = true;
-			mc->moveToStaging();
-		}
-	} else {
-		if (mc->hasReachedTarget()) {
-			once = false;
-			state = ZR_IDLE;
-		}
+	if (mc->hasReachedTarget()) {
+		finishedAt = clockTicks;
+		state = ZR_IDLE;
 	}
 }
 
@@ -125,5 +153,12 @@ void ZeroReturnController::emergencyStop() {
 }
 
 void ZeroReturnController::reportStatus(void *rout) {
-	return;
+	ZR_STATUS *status = &((ROBOT_OUT *) rout)->zrStatus;
+	status->isHoming = state != ZR_IDLE;
+	if (state != ZR_IDLE) {
+		status->homingMs = clockTicks - startedAt;
+	} else {
+		// A zero return cut short by an error has no duration
+		status->homingMs = finishedAt < 0 ? 0 : finishedAt - startedAt;
+	}
 }
@@ -8,25 +8,38 @@
 #ifndef SRC_SOFTWARE_ZERORETURN_ZERORETURNCONTROLLER_H_
 #define SRC_SOFTWARE_ZERORETURN_ZERORETURNCONTROLLER_H_
 
+#include <SharedMemoryStructs.h>
+#include <stdint.h>
+
+#include "../../Utilities/Axis.h"
 #include "../../Utilities/ComponentInterface.h"
 
 class MotorController;
+class PositionSnapshot;
 
 /**
  * Zero Return States
  */
 enum ZERO_RETURN_STATE {
 	ZR_IDLE,												/**< The motors are not zeroing */
-	ZR_STARTED,												/**< Command z axis to zero */
-	ZR_ZEROING_Z, 											/**< Wait for z axis to finish zeroing */
-	ZR_AT_Z_ZERO, 											/**< Command x and y axes to zero */
-	ZR_ZEROING_XY, 											/**< Wait for x and y axes to finish zeroing */
-	ZR_MOVE_OFF_LIM_SWITCH, 								/**< Command x, y, and z axes to move off limit switches */
-	ZR_MOVING_OFF_SWITCH,									/**< Wait for x, y, and z axes to finish moving off switches */
-	ZR_AT_ZERO,												/**< Command x, y, and z axes to staging area */
+	ZR_STARTED,												/**< Command z axis to its limit switch */
+	ZR_HOMING, 												/**< Wait for every axis to home, x and y start once z has found its switch */
+	ZR_AT_ZERO,												/**< Wait for the home positions, then command x, y, and z axes to staging area */
 	ZR_MOVING_TO_STAGING									/**< Wait for x, y, and z axes to reach staging area */
 };
 
+/**
+ * Homing Phases, of each axis
+ */
+enum HOMING_PHASE {
+	HP_WAITING,												/**< The axis has not started homing */
+	HP_APPROACHING,											/**< Running to the limit switch at the fast homing speed */
+	HP_BACKING_OFF,											/**< Moving back off the switch it found */
+	HP_ZEROING,												/**< Re-approaching the switch at the creep speed */
+	HP_MOVING_OFF_SWITCH,									/**< Moving off the switch to the home position */
+	HP_HOMED												/**< Home is set */
+};
+
 /**
  * @class ZeroReturnController
  * @brief Responsible for zeroing each axis of the Pick-Robot.
@@ -34,12 +47,17 @@ enum ZERO_RETURN_STATE {
  * Handles the independent motion of zeroing each access, by decoupling from
  * 	the actions within the #PickController. First the z axis will zero, while x and y axes
  * 	remain static, to ensure that arm is free of any obstructions that may have resulted
- * 	from previous picks (if any). Once the z axis has finished zeroing, x and y will
- * 	zero together until each axis is against their respective limit switches.
- * 	Once axes zero they will move, only slightly, off the limit switches, mark their
- * 	current location as the home location, then move to the designated staging area.
- * 	This action, of moving off limit switches, is in place to ensure that they never
- * 	are unintentionally re-depressed during normal operations, which would stop axes motion.
+ * 	from previous picks (if any). Once the z axis has found its limit switch, x and y will
+ * 	zero together while z finishes.
+ *
+ * Each axis homes in two passes: it runs to its limit switch at its fast homing speed,
+ * 	backs off #HOMING_BACK_OFF_MM, then re-approaches the switch at its creep speed, so only
+ * 	the last few millimeters are slow and the switch is still found precisely. Once an
+ * 	axis is against its switch it will move, only slightly, off the limit switch and mark
+ * 	its current location as the home location. When every axis is home they move to the
+ * 	designated staging area. This action, of moving off limit switches, is in place to
+ * 	ensure that they never are unintentionally re-depressed during normal operations,
+ * 	which would stop axes motion.
  */
 class ZeroReturnController: public ComponentInterface {
 private:
@@ -47,77 +65,57 @@ private:
 	bool zeroed;
 	/** A reference to the #MotorController, to provide motion. */
 	MotorController *mc;
+	/** Homing phase of each axis. */
+	HOMING_PHASE phases[NUM_AXES];
+	/** Clock tick of the last #step. */
+	long long int clockTicks;
+	/** Clock tick the last zero return started. */
+	long long int startedAt;
+	/** Clock tick the last zero return reached the staging area, -1 until it does. */
+	long long int finishedAt;
+	/** Where positions are kept across restarts, NULL if they aren't. */
+	PositionSnapshot *snapshot;
+	/** PositionSnapshot::getGeometry of the configuration in use. */
+	uint32_t geometry;
+
+	/**
+	 * @fn getHomingDirection
+	 * @return The direction of @p axis's limit switch.
+	 */
+	static DIRECTION getHomingDirection(AXIS axis);
 
 	/**
 	 * @fn zeroReturnAxisZ
 	 * @brief Command the z axis in the direction of the z axis limit switch.
 	 *
 	 * Instructs the z axis motors to move in the direction of their limit
-	 * 	switches. Moves at a pre-defined slow speed since relative motor
-	 * 	position is unknown.
+	 * 	switches at their fast homing speed, x and y wait until it finds them.
 	 *
 	 * Sets:
-	 * 		- #state : #ZR_ZEROING_Z
+	 * 		- #state : #ZR_HOMING
 	 */
 	void zeroReturnAxisZ();
 
 	/**
-	 * @fn zeroReturnAxesXY
-	 * @brief Command the x and y axes in the direction of their limit switches.
-	 *
-	 * Instructs the x and y axes motors to move in the direction of their limit
-	 * 	switches. Moves at a pre-defined slow speed since relative motor
-	 * 	position is unknown.
-	 *
-	 * Sets:
-	 * 		- #state : #ZR_ZEROING_XY
-	 */
-	void zeroReturnAxesXY();
-
-	/**
-	 * @fn checkLimitSwitchZ
-	 * @brief Check if the z limit switch is depressed.
+	 * @fn homeAxes
+	 * @brief Advance each axis through its #HOMING_PHASE as it reaches each target.
 	 *
-	 * Sets:
-	 * 		- #state : #ZR_AT_Z_ZERO
-	 */
-	void checkLimitSwitchZ();
-
-	/**
-	 * @fn checkLimitSwitchXY
-	 * @brief Check if x and y limit switches are depressed.
-	 *
-	 * Sets:
-	 * 		- #state : #ZR_MOVE_OFF_LIM_SWITCH
-	 */
-	void checkLimitSwitchXY();
-
-	/**
-	 * @fn moveToOffset
-	 * @brief Command motors off of limit switches.
-	 *
-	 * Sets:
-	 * 		- #state : #ZR_MOVING_OFF_SWITCH
+	 * Once every axis is #HP_HOMED:
+	 * 		- #zeroed : `true`
+	 * 		- #state : #ZR_AT_ZERO
 	 */
-	void moveToOffset();
+	void homeAxes();
 
 	/**
-	 * @fn waitUntilAtOffset
-	 * @brief Wait until each motor has move off their respective limit switches.
-	 *
-	 * Each motor will come to a stop once, the limit switch is no longer depressed,
-	 * 	at which point the current location of each motor will be set as their home
-	 * 	position. This ensures the limit switches are not accidently depressed at anytime
-	 * 	during normal pick-routine operations.
-	 *
-	 * Sets:
-	 * 		- #state : #ZR_AT_ZERO
+	 * @fn homeAxis
+	 * @brief Command @p axis's next homing motion, if it finished the last.
 	 */
-	void waitUntilAtOffset();
+	void homeAxis(AXIS axis);
 
 	/**
 	 * @fn moveToStaging
-	 * @brief Command each motor to the preset staging area.
+	 * @brief Command each motor to the preset staging area, once their home positions
+	 * 	have been read back.
 	 *
 	 * Sets:
 	 * 		- #state : #ZR_MOVING_TO_STAGING
@@ -131,6 +129,7 @@ private:
 	 *
 	 * Once axes are at the staging location:
 	 * 		- #state : #ZR_IDLE
+	 * 		- #finishedAt : the current clock tick
 	 */
 	void waitUntilAtStaging();
 public:
@@ -152,17 +151,46 @@ public:
 	 * @brief Responsible for determining next appropriate #ZERO_RETURN_STATE.
 	 *
 	 * If no errors persist, this function handles the state-machine which drives the
-	 * 	zeroing motions of the system.
+	 * 	zeroing motions of the system. Then records the motor positions in the #snapshot.
 	 * @param[in] clockTicks The current clock tick in milliseconds.
 	 */
 	void step(long long int clockTicks);
 
 	/**
 	 * @fn reportStatus
-	 * @brief *** Not Implemented ***
+	 * @brief Report whether a zero return is running and how long it has taken to #ROBOT_OUT.
+	 * @param[in] rout A reference to #ROBOT_OUT.
 	 */
 	void reportStatus(void * rout);
 
+	/**
+	 * @fn restore
+	 * @brief Keep @p snapshot up to date from now on, resuming the zero it proves.
+	 *
+	 * If PositionSnapshot::canResume, the motors haven't moved or lost power since the
+	 * 	last run left them homed and at rest, and #zeroed is set without a zero return.
+	 * @param[in] snapshot The snapshot loaded at startup.
+	 * @param[in] geometry PositionSnapshot::getGeometry of the configuration in use.
+	 * @return Whether the zero was resumed.
+	 */
+	bool restore(PositionSnapshot *snapshot, uint32_t geometry);
+
+	/**
+	 * @fn getGeometry
+	 * @return PositionSnapshot::getGeometry of the configuration #zeroed was found with.
+	 */
+	uint32_t getGeometry() {
+		return geometry;
+	}
+
+	/**
+	 * @fn setGeometry
+	 * @brief Record the geometry of a newly loaded configuration. Call #clearZero too if it changed.
+	 */
+	void setGeometry(uint32_t geometry) {
+		this->geometry = geometry;
+	}
+
 	/**
 	 * @fn emergencyStop
 	 * @brief Calls #clearZero.
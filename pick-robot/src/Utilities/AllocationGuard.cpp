@@ -0,0 +1,127 @@
+#include "AllocationGuard.h"
+
+#ifdef ALLOCATION_GUARD
+
+#include <execinfo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+}
+
+/** A call site caught allocating */
+typedef struct {
+	void *frames[ALLOCATION_GUARD_DEPTH];	/**< Backtrace, innermost first */
+	int depth;								/**< Frames recorded */
+} ALLOCATION_SITE;
+
+/** Whether the thread's allocations are caught */
+static __thread bool armed = false;
+/** Allocations caught */
+static unsigned long caught = 0;
+/** Distinct call sites caught */
+static ALLOCATION_SITE sites[ALLOCATION_GUARD_SITES];
+/** Number of #sites */
+static int numberOfSites = 0;
+/** Number of #sites already reported */
+static int reportedSites = 0;
+/** Allocations from call sites caught after #sites filled up */
+static unsigned long unrecorded = 0;
+
+static void catchAllocation(void *caller) {
+	// Recording must not allocate, and nothing below may recurse into the guard
+	armed = false;
+	caught++;
+	bool known = false;
+	for (int site = 0; site < numberOfSites && !known; site++) {
+		for (int frame = 0; frame < sites[site].depth && !known; frame++) {
+			known = sites[site].frames[frame] == caller;
+		}
+	}
+	if (!known) {
+		if (numberOfSites < ALLOCATION_GUARD_SITES) {
+			ALLOCATION_SITE *site = &sites[numberOfSites++];
+			site->depth = backtrace(site->frames, ALLOCATION_GUARD_DEPTH);
+		} else {
+			unrecorded++;
+		}
+	}
+	armed = true;
+}
+
+void allocationGuardInit() {
+	void *frames[1];
+	backtrace(frames, 1);
+}
+
+void allocationGuardArm() {
+	armed = true;
+}
+
+void allocationGuardDisarm() {
+	armed = false;
+}
+
+unsigned long allocationGuardReport() {
+	if (reportedSites < numberOfSites) {
+		fprintf(stderr, "%lu allocations in the real-time loop so far, new call sites:\n", caught);
+	}
+	for (; reportedSites < numberOfSites; reportedSites++) {
+		backtrace_symbols_fd(sites[reportedSites].frames, sites[reportedSites].depth, 2);
+		fprintf(stderr, "\n");
+	}
+	if (unrecorded > 0) {
+		fprintf(stderr, "%lu more allocations from unrecorded call sites.\n", unrecorded);
+		unrecorded = 0;
+	}
+	return caught;
+}
+
+extern "C" void *malloc(size_t size) {
+	if (armed) {
+		catchAllocation(__builtin_return_address(0));
+	}
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) {
+	if (armed) {
+		catchAllocation(__builtin_return_address(0));
+	}
+	return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size) {
+	if (armed) {
+		catchAllocation(__builtin_return_address(0));
+	}
+	return __libc_realloc(pointer, size);
+}
+
+void *operator new(size_t size) {
+	if (armed) {
+		catchAllocation(__builtin_return_address(0));
+	}
+	void *pointer = __libc_malloc(size);
+	if (pointer == NULL) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void *operator new[](size_t size) {
+	if (armed) {
+		catchAllocation(__builtin_return_address(0));
+	}
+	void *pointer = __libc_malloc(size);
+	if (pointer == NULL) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+#endif
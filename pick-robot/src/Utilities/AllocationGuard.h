@@ -0,0 +1,73 @@
+#ifndef SRC_UTILITIES_ALLOCATIONGUARD_H_
+#define SRC_UTILITIES_ALLOCATIONGUARD_H_
+
+/**
+ * @file AllocationGuard.h
+ * @brief Catches heap allocations made from inside the real-time loop.
+ *
+ * Built with ALLOCATION_GUARD defined, malloc, calloc, realloc and operator new
+ * 	are intercepted. While the calling thread is armed every allocation is counted
+ * 	and the backtrace of each new call site recorded, without allocating. Link with
+ * 	-rdynamic to see function names in the report. Without ALLOCATION_GUARD every
+ * 	call compiles to nothing. The guard replaces the C library's allocator, which
+ * 	only glibc allows, so other C libraries build without it.
+ */
+
+/** Distinct call sites recorded, each is reported once. */
+#define ALLOCATION_GUARD_SITES 16
+/** Frames recorded per call site. */
+#define ALLOCATION_GUARD_DEPTH 10
+
+#ifdef ALLOCATION_GUARD
+#include <stdlib.h>
+#ifndef __GLIBC__
+#warning "The allocation guard needs glibc, building without it"
+#undef ALLOCATION_GUARD
+#endif
+#endif
+
+#ifdef ALLOCATION_GUARD
+
+/**
+ * @fn allocationGuardInit
+ * @brief Prepare the backtrace machinery, which allocates the first time it is used.
+ */
+void allocationGuardInit();
+
+/**
+ * @fn allocationGuardArm
+ * @brief Start catching allocations made by the calling thread.
+ */
+void allocationGuardArm();
+
+/**
+ * @fn allocationGuardDisarm
+ * @brief Stop catching allocations made by the calling thread.
+ */
+void allocationGuardDisarm();
+
+/**
+ * @fn allocationGuardReport
+ * @brief Print the call sites first caught since the last report to stderr. Call disarmed.
+ * @return The number of allocations caught since #allocationGuardInit.
+ */
+unsigned long allocationGuardReport();
+
+#else
+
+static inline void allocationGuardInit() {
+}
+
+static inline void allocationGuardArm() {
+}
+
+static inline void allocationGuardDisarm() {
+}
+
+static inline unsigned long allocationGuardReport() {
+	return 0;
+}
+
+#endif
+
+#endif /* SRC_UTILITIES_ALLOCATIONGUARD_H_ */
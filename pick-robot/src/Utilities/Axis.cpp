@@ -1,5 +1,6 @@
 #include "Axis.h"
 
+#include <algorithm>
 #include <cmath>
 
 /**
@@ -14,12 +15,12 @@ void Axis::goToTarget(axis_pos positionMm) {
 }
 
 /**
- * Goes at specified speed
+ * Goes at specified speed, rounded up to whole steps/second
  */
 void Axis::goToTarget(axis_pos positionMm, double mmPerSec) {
 	for (MotorInterface *motor : this->assignedMotors) {
 		if (motor != nullptr) {
-			motor->goTo(motor->mmToSteps(positionMm), motor->mmToSteps(mmPerSec));
+			motor->goTo(motor->mmToSteps(positionMm), std::ceil(motor->getStepsPerRev() / motor->getMMPerRev() * mmPerSec));
 		}
 	}
 }
@@ -31,10 +32,57 @@ axis_pos Axis::getCurrentPositionMM() {
 	if (this->assignedMotors.size() < 1) {
 		return 0;
 	}
-	return this->assignedMotors[0]->getPositionInMM();
+	return this->assignedMotors.motors[0]->getPositionInMM();
 }
 
-std::vector<MotorInterface *> Axis::getMotorObj() {
+double Axis::getMaxSpeedMMPerSec() {
+	double mmPerSec = 0;
+	for (MotorInterface *motor : this->assignedMotors) {
+		double motorMMPerSec = motor->getMaxSpeed() * motor->getMMPerRev() / motor->getStepsPerRev();
+		mmPerSec = mmPerSec == 0 ? motorMMPerSec : std::min(mmPerSec, motorMMPerSec);
+	}
+	return mmPerSec;
+}
+
+/*
+ * Grouped motors should be the same thus one value will be returned
+ */
+double Axis::getSpeedMMPerSec() {
+	if (this->assignedMotors.size() < 1) {
+		return 0;
+	}
+	MotorInterface *motor = this->assignedMotors.motors[0];
+	return motor->getSpeed() * motor->getMMPerRev() / motor->getStepsPerRev();
+}
+
+double Axis::getAccelerationMMPerSec2() {
+	double mmPerSec2 = 0;
+	for (MotorInterface *motor : this->assignedMotors) {
+		double motorMMPerSec2 = motor->getAcceleration() * motor->getMMPerRev() / motor->getStepsPerRev();
+		mmPerSec2 = mmPerSec2 == 0 ? motorMMPerSec2 : std::min(mmPerSec2, motorMMPerSec2);
+	}
+	return mmPerSec2;
+}
+
+double Axis::getDecelerationMMPerSec2() {
+	double mmPerSec2 = 0;
+	for (MotorInterface *motor : this->assignedMotors) {
+		double motorMMPerSec2 = motor->getDeceleration() * motor->getMMPerRev() / motor->getStepsPerRev();
+		mmPerSec2 = mmPerSec2 == 0 ? motorMMPerSec2 : std::min(mmPerSec2, motorMMPerSec2);
+	}
+	return mmPerSec2;
+}
+
+bool Axis::reachedTarget() {
+	for (MotorInterface *motor : this->assignedMotors) {
+		if (!motor->reachedTarget()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+const MotorSpan &Axis::getMotorObj() {
 	return this->assignedMotors;
 }
 
@@ -42,10 +90,21 @@ AXIS Axis::getAxis() {
 	return this->axis;
 }
 
-//TODO:
 void Axis::zero(DIRECTION dir) {
 	for (MotorInterface *motor : this->assignedMotors) {
-		motor->zeroReturn(dir);
+		motor->zeroReturn(dir, this->homingCreepStepsPerSec);
+	}
+}
+
+void Axis::approachLimitSwitch(DIRECTION dir) {
+	for (MotorInterface *motor : this->assignedMotors) {
+		motor->zeroReturn(dir, this->homingStepsPerSec);
+	}
+}
+
+void Axis::backOffLimitSwitch(DIRECTION dir) {
+	for (MotorInterface *motor : this->assignedMotors) {
+		motor->backOffLimitSwitch(dir, round(motor->mmToSteps(HOMING_BACK_OFF_MM)), this->homingStepsPerSec);
 	}
 }
 
@@ -76,8 +135,10 @@ void Axis::softStop() {
 void Axis::updateConfiguration(AXIS_CONFIG *axis) {
 	this->stagingArea = axis->stagingArea;
 	this->travelLimit = axis->travelLimitmm;
+	this->homingStepsPerSec = axis->homingStepsPerSec;
+	this->homingCreepStepsPerSec = axis->homingCreepStepsPerSec;
 	for (unsigned int i = 0; i < this->assignedMotors.size(); i++) {
-		this->assignedMotors.at(i)->updateConfig(&(axis->motor[i]));
+		this->assignedMotors.motors[i]->updateConfig(&(axis->motor[i]));
 	}
 }
 
@@ -13,11 +13,36 @@
 
 /** The number of allowable axes. */
 #define NUM_AXES 3
+/** The bit of an #AXIS in an axis mask. */
+#define AXIS_BIT(axis) (1u << (axis))
+/** The axis mask of every axis. */
+#define ALL_AXES ((1u << NUM_AXES) - 1)
 /** Number of allowable motors per axis. */
 #define MAX_MOTORS_PER_AXIS 2
 
 /** Distance in millimeters to travel off of limit switches, when setting home postion. */
 #define HOME_POSITION_OFFSET -10
+/** Distance in millimeters to back off the limit switch between the fast and the slow approach. */
+#define HOMING_BACK_OFF_MM 5
+
+/**
+ * @struct MotorSpan
+ * @brief An axis's motors in fixed storage, iterable without copying or allocating.
+ */
+struct MotorSpan {
+	MotorInterface *motors[MAX_MOTORS_PER_AXIS];	/**< The motors */
+	unsigned int count;								/**< Number of motors */
+
+	MotorInterface *const *begin() const {
+		return motors;
+	}
+	MotorInterface *const *end() const {
+		return motors + count;
+	}
+	unsigned int size() const {
+		return count;
+	}
+};
 
 inline char getAxisLetter(AXIS axis) {
 	switch (axis) {
@@ -43,19 +68,29 @@ class Axis {
 public:
 	/**
 	 * @param[in] axisConfig A reference to the configuration for each axis.
-	 * @param[in] assignedMotors Vector of the allocated motors for the desired axis.
+	 * @param[in] assignedMotors Vector of the allocated motors for the desired axis,
+	 * 	only the first #MAX_MOTORS_PER_AXIS are used.
 	 *
 	 * Sets:
 	 * 		- #axis : @p axis
 	 * 		- #travelLimit : @p axisConfig->travelLimitmm
 	 * 		- #stagingArea : @p axisConfig->stagingArea
+	 * 		- #homingStepsPerSec : @p axisConfig->homingStepsPerSec
+	 * 		- #homingCreepStepsPerSec : @p axisConfig->homingCreepStepsPerSec
 	 */
 	Axis(AXIS axis, AXIS_CONFIG * axisConfig, const std::vector<MotorInterface *> &assignedMotors) :
 		axis(axis),
 		travelLimit(axisConfig->travelLimitmm),
-		assignedMotors(assignedMotors),
-		stagingArea(axisConfig->stagingArea)
+		assignedMotors(),
+		stagingArea(axisConfig->stagingArea),
+		homingStepsPerSec(axisConfig->homingStepsPerSec),
+		homingCreepStepsPerSec(axisConfig->homingCreepStepsPerSec)
 		{
+			for (MotorInterface *motor : assignedMotors) {
+				if (this->assignedMotors.count < MAX_MOTORS_PER_AXIS) {
+					this->assignedMotors.motors[this->assignedMotors.count++] = motor;
+				}
+			}
 			std::cout << "Axis Created." << std::endl;
 		}
 	virtual ~Axis() {}
@@ -88,7 +123,7 @@ public:
 	 * @fn getMotorObj
 	 * @return A reference to the allocated motors for the axis.
 	 */
-	std::vector<MotorInterface *> getMotorObj();
+	const MotorSpan &getMotorObj();
 
 	/**
 	 * @fn getAxis
@@ -98,11 +133,25 @@ public:
 
 	/**
 	 * @fn zero
-	 * @brief An axis motion command to zero the current axis.
+	 * @brief An axis motion command to zero the current axis, slowly so it stops right on the switch.
 	 * @param[in] dir The direction to zero.
 	 */
 	void zero(DIRECTION dir);
 
+	/**
+	 * @fn approachLimitSwitch
+	 * @brief Run the axis to its limit switch at #homingStepsPerSec, to find it before #zero.
+	 * @param[in] dir The direction to zero.
+	 */
+	void approachLimitSwitch(DIRECTION dir);
+
+	/**
+	 * @fn backOffLimitSwitch
+	 * @brief Move the axis #HOMING_BACK_OFF_MM away from its limit switch, so #zero has a switch to find.
+	 * @param[in] dir The direction to zero.
+	 */
+	void backOffLimitSwitch(DIRECTION dir);
+
 	/**
 	 * @fn moveAxisOffLimitSwitches
 	 * @brief Move the axis motors off of the limit switches.
@@ -127,6 +176,36 @@ public:
 	 */
 	void softStop();
 
+	/**
+	 * @fn getMaxSpeedMMPerSec
+	 * @return The fastest speed every assigned motor can travel, in millimeters/second.
+	 */
+	double getMaxSpeedMMPerSec();
+
+	/**
+	 * @fn getAccelerationMMPerSec2
+	 * @return The acceleration every assigned motor can follow, in millimeters/second².
+	 */
+	double getAccelerationMMPerSec2();
+
+	/**
+	 * @fn getSpeedMMPerSec
+	 * @return The current speed of the axis in millimeters/second, regardless of direction.
+	 */
+	double getSpeedMMPerSec();
+
+	/**
+	 * @fn getDecelerationMMPerSec2
+	 * @return The deceleration every assigned motor can follow, in millimeters/second².
+	 */
+	double getDecelerationMMPerSec2();
+
+	/**
+	 * @fn reachedTarget
+	 * @return Whether every assigned motor has reached its target.
+	 */
+	bool reachedTarget();
+
 	/**
 	 * @fn getTravelLimit
 	 * @return Lower bound of axis travel limit since upper bound is always 0.
@@ -147,7 +226,7 @@ public:
 	 * @fn updateConfiguration
 	 * @brief Update the current axis configurations.
 	 *
-	 * Updates the #stagingArea, #travelLimit, and #assignedMotors.
+	 * Updates the #stagingArea, #travelLimit, homing speeds, and #assignedMotors.
 	 */
 	void updateConfiguration(AXIS_CONFIG *axis);
 
@@ -171,9 +250,13 @@ private:
 	/** Axis travel limit. */
 	axis_pos travelLimit;
 	/** Allocated motors for the axis. */
-	std::vector<MotorInterface *> assignedMotors;
+	MotorSpan assignedMotors;
 	/** Desired staging area. */
 	axis_pos stagingArea;
+	/** Speed of the first approach to the limit switch, steps/second. */
+	int homingStepsPerSec;
+	/** Speed of the zero return that sets home, steps/second. */
+	int homingCreepStepsPerSec;
 };
 
 #endif /* SRC_UTILITIES_AXIS_H_ */
@@ -28,6 +28,30 @@ public:
 	 * Immediately stop component interactions.
 	 */
 	virtual void emergencyStop() = 0;
+
+	/**
+	 * @fn getPeriod
+	 * Number of ticks between calls to #step and #reportStatus.
+	 */
+	virtual unsigned int getPeriod() {
+		return 1;
+	}
+
+	/**
+	 * @fn getPhase
+	 * Tick, modulo #getPeriod, the component runs on. -1 lets the scheduler spread it.
+	 */
+	virtual int getPhase() {
+		return -1;
+	}
+
+	/**
+	 * @fn getStepCostUs
+	 * Worst case duration of #step plus #reportStatus in microseconds, checked against the tick budget.
+	 */
+	virtual unsigned int getStepCostUs() {
+		return 10;
+	}
 //	virtual void reset() = 0;
 };
 #endif
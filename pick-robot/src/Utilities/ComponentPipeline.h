@@ -0,0 +1,207 @@
+#ifndef SRC_UTILITIES_COMPONENTPIPELINE_H_
+#define SRC_UTILITIES_COMPONENTPIPELINE_H_
+
+/**
+ * @file ComponentPipeline.h
+ */
+
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+
+#include "ComponentProfiler.h"
+#include "ComponentScheduler.h"
+#include "CycleCounter.h"
+
+/**
+ * @class TickPipeline
+ * @brief The per-tick calls of a #ComponentPipeline, whatever its component types.
+ *
+ * The real-time loop makes one virtual call per tick into the pipeline; the
+ * 	components inside are called directly.
+ */
+class TickPipeline {
+public:
+	virtual ~TickPipeline() {}
+
+	/**
+	 * @fn step
+	 * @brief Step the components due on @p clockTicks.
+	 * @param[in] clockTicks The current clock tick in milliseconds.
+	 */
+	virtual void step(long long int clockTicks) = 0;
+
+	/**
+	 * @fn reportStatus
+	 * @brief Report the components that stepped this tick.
+	 * @param[out] robotOut The #ROBOT_OUT being built.
+	 */
+	virtual void reportStatus(void *robotOut) = 0;
+
+	/**
+	 * @fn isComplete
+	 * @return Whether every component added to the scheduler is in the pipeline.
+	 */
+	virtual bool isComplete() = 0;
+};
+
+/**
+ * @struct PipelineStage
+ * @brief Up to @p Capacity components of the concrete type @p Component, stepped in the order added.
+ */
+template<typename Component, unsigned int Capacity = 1>
+struct PipelineStage {
+	typedef Component Type;							/**< The concrete component type */
+	static const unsigned int capacity = Capacity;	/**< Most components the stage holds */
+
+	Component *components[Capacity];				/**< The components */
+	SCHEDULE_SLOT slots[Capacity];					/**< Their slots, from ComponentScheduler::plan */
+	long long int nextTick[Capacity];				/**< Next tick each component is due on */
+	bool due[Capacity];								/**< Whether each component stepped this tick */
+	unsigned int count;								/**< Number of components added */
+};
+
+/**
+ * @class ComponentPipeline
+ * @brief Steps a fixed list of concrete component types without virtual dispatch.
+ *
+ * Each #PipelineStage is a member of a tuple and is walked by template recursion,
+ * 	so the component calls are qualified, direct and in a fixed order. Components
+ * 	keep the period, phase and profiling the #ComponentScheduler planned for them;
+ * 	the scheduler still handles #ComponentScheduler::emergencyStop.
+ *
+ * The pipeline is built once, after ComponentScheduler::plan, and never allocates.
+ */
+template<typename... Stages>
+class ComponentPipeline : public TickPipeline {
+private:
+	typedef std::tuple<Stages...> STAGES;
+	static const unsigned int NUMBER_OF_STAGES = sizeof...(Stages);
+
+	/** The stages, in tick order */
+	STAGES stages;
+	/** Provides each component's slot */
+	ComponentScheduler *scheduler;
+	/** Times every call */
+	ComponentProfiler *profiler;
+	/** Number of components added */
+	unsigned int added;
+
+	template<unsigned int I>
+	typename std::enable_if<I == NUMBER_OF_STAGES>::type stepStage(long long int, uint64_t &) {
+	}
+
+	template<unsigned int I>
+	typename std::enable_if<I < NUMBER_OF_STAGES>::type stepStage(long long int clockTicks, uint64_t &start) {
+		typedef typename std::tuple_element<I, STAGES>::type Stage;
+		typedef typename Stage::Type Component;
+		Stage &stage = std::get<I>(stages);
+		for (unsigned int index = 0; index < stage.count; index++) {
+			const SCHEDULE_SLOT &slot = stage.slots[index];
+			if (stage.nextTick[index] < clockTicks) {
+				// First tick, or ticks were skipped
+				stage.nextTick[index] = clockTicks + (slot.phase + slot.period - clockTicks % slot.period) % slot.period;
+			}
+			stage.due[index] = stage.nextTick[index] == clockTicks;
+			if (stage.due[index]) {
+				stage.nextTick[index] += slot.period;
+				stage.components[index]->Component::step(clockTicks);
+				uint64_t end = readCycleCounter();
+				profiler->recordStep(slot.profile, end - start);
+				start = end;
+			}
+		}
+		stepStage<I + 1>(clockTicks, start);
+	}
+
+	template<unsigned int I>
+	typename std::enable_if<I == NUMBER_OF_STAGES>::type reportStage(void *, uint64_t &) {
+	}
+
+	template<unsigned int I>
+	typename std::enable_if<I < NUMBER_OF_STAGES>::type reportStage(void *robotOut, uint64_t &start) {
+		typedef typename std::tuple_element<I, STAGES>::type Stage;
+		typedef typename Stage::Type Component;
+		Stage &stage = std::get<I>(stages);
+		for (unsigned int index = 0; index < stage.count; index++) {
+			if (stage.due[index]) {
+				stage.components[index]->Component::reportStatus(robotOut);
+				uint64_t end = readCycleCounter();
+				profiler->recordReport(stage.slots[index].profile, end - start);
+				start = end;
+			}
+		}
+		reportStage<I + 1>(robotOut, start);
+	}
+
+	template<unsigned int I, typename Component>
+	typename std::enable_if<I == NUMBER_OF_STAGES, bool>::type addToStage(Component *) {
+		return false;
+	}
+
+	template<unsigned int I, typename Component>
+	typename std::enable_if<I < NUMBER_OF_STAGES, bool>::type addToStage(Component *component) {
+		typedef typename std::tuple_element<I, STAGES>::type Stage;
+		return addToStage<I>(component, std::is_same<typename Stage::Type, Component>());
+	}
+
+	template<unsigned int I, typename Component>
+	bool addToStage(Component *component, std::false_type) {
+		return addToStage<I + 1>(component);
+	}
+
+	template<unsigned int I, typename Component>
+	bool addToStage(Component *component, std::true_type) {
+		typedef typename std::tuple_element<I, STAGES>::type Stage;
+		Stage &stage = std::get<I>(stages);
+		if (stage.count >= Stage::capacity || !scheduler->getSlot(component, &stage.slots[stage.count])) {
+			return false;
+		}
+		stage.components[stage.count] = component;
+		stage.nextTick[stage.count] = -1;
+		stage.due[stage.count] = false;
+		stage.count++;
+		added++;
+		return true;
+	}
+
+public:
+	/**
+	 * @param[in] scheduler The planned scheduler holding every component's slot.
+	 * @param[in] profiler Times every #step and #reportStatus call.
+	 */
+	ComponentPipeline(ComponentScheduler *scheduler, ComponentProfiler *profiler)
+		: stages(),
+		  scheduler(scheduler),
+		  profiler(profiler),
+		  added(0) {
+	}
+	virtual ~ComponentPipeline() {}
+
+	/**
+	 * @fn add
+	 * @brief Add a component to the first stage of its exact type that has room.
+	 * @param[in] component The component, already added to the scheduler.
+	 * @return Whether a stage took it.
+	 */
+	template<typename Component>
+	bool add(Component *component) {
+		return addToStage<0>(component);
+	}
+
+	void step(long long int clockTicks) {
+		uint64_t start = readCycleCounter();
+		stepStage<0>(clockTicks, start);
+	}
+
+	void reportStatus(void *robotOut) {
+		uint64_t start = readCycleCounter();
+		reportStage<0>(robotOut, start);
+	}
+
+	bool isComplete() {
+		return added == scheduler->getNumberOfComponents();
+	}
+};
+
+#endif /* SRC_UTILITIES_COMPONENTPIPELINE_H_ */
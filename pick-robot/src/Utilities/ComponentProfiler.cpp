@@ -0,0 +1,69 @@
+#include "ComponentProfiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+ComponentProfiler::ComponentProfiler() {
+	numberOfComponents = 0;
+	ticks = 0;
+	window = 0;
+	nsPerCycle = 1e9 / cycleCounterFrequency();
+	memset(names, 0, sizeof(names));
+	memset(stepWindows, 0, sizeof(stepWindows));
+	memset(reportWindows, 0, sizeof(reportWindows));
+	for (int index = 0; index < MAX_PROFILED_COMPONENTS; index++) {
+		stepWindows[index].minCycles = UINT32_MAX;
+		reportWindows[index].minCycles = UINT32_MAX;
+	}
+}
+
+ComponentProfiler::~ComponentProfiler() {
+}
+
+int ComponentProfiler::add(const char *name) {
+	if (numberOfComponents >= MAX_PROFILED_COMPONENTS) {
+		printf("Too many components, %s will not be profiled.\n", name);
+		return -1;
+	}
+	snprintf(names[numberOfComponents], PROFILE_NAME_LENGTH, "%s", name);
+	return numberOfComponents++;
+}
+
+void ComponentProfiler::summarize(WINDOW *window, PROFILE_STATS *stats) {
+	if (window->calls == 0) {
+		memset(stats, 0, sizeof(PROFILE_STATS));
+	} else {
+		stats->minNs = window->minCycles * nsPerCycle;
+		stats->avgNs = window->totalCycles * nsPerCycle / window->calls;
+		stats->maxNs = window->maxCycles * nsPerCycle;
+		uint32_t rank = window->calls - window->calls / 100;
+		uint32_t seen = 0;
+		for (int bucket = 0; bucket < PROFILE_HISTOGRAM_BUCKETS; bucket++) {
+			seen += window->buckets[bucket];
+			if (seen >= rank) {
+				// Bucket n holds [2^n, 2^(n+1)) cycles, never report more than the max
+				double bound = (double) (1ULL << (bucket + 1)) * nsPerCycle;
+				stats->p99Ns = bound < stats->maxNs ? bound : stats->maxNs;
+				break;
+			}
+		}
+	}
+	memset(window, 0, sizeof(WINDOW));
+	window->minCycles = UINT32_MAX;
+}
+
+void ComponentProfiler::endTick(COMPONENT_PROFILES *profiles) {
+	if (++ticks < PROFILE_WINDOW_TICKS) {
+		return;
+	}
+	ticks = 0;
+	window++;
+	profiles->window = window;
+	profiles->windowTicks = PROFILE_WINDOW_TICKS;
+	profiles->numberOfComponents = numberOfComponents;
+	for (int index = 0; index < numberOfComponents; index++) {
+		memcpy(profiles->components[index].name, names[index], PROFILE_NAME_LENGTH);
+		summarize(&stepWindows[index], &profiles->components[index].step);
+		summarize(&reportWindows[index], &profiles->components[index].report);
+	}
+}
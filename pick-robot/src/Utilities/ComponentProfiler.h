@@ -0,0 +1,125 @@
+#ifndef SRC_UTILITIES_COMPONENTPROFILER_H_
+#define SRC_UTILITIES_COMPONENTPROFILER_H_
+
+/**
+ * @file ComponentProfiler.h
+ */
+
+#include <SharedMemoryStructs.h>
+#include <stdint.h>
+
+#include "CycleCounter.h"
+
+/** Ticks per profiling window, the published statistics cover the last complete window. */
+#define PROFILE_WINDOW_TICKS 1000
+/** Number of power of two buckets used to estimate the 99th percentile. */
+#define PROFILE_HISTOGRAM_BUCKETS 32
+
+/**
+ * @class ComponentProfiler
+ * @brief Measures every #ComponentInterface::step and #ComponentInterface::reportStatus call.
+ *
+ * Calls are timed with #readCycleCounter and accumulated per component into fixed
+ * 	windows of #PROFILE_WINDOW_TICKS ticks. Recording is constant time; the
+ * 	statistics are only summarized into #COMPONENT_PROFILES when a window closes.
+ */
+class ComponentProfiler {
+private:
+	/** Accumulated calls of one call site over the current window */
+	typedef struct {
+		uint64_t totalCycles;							/**< Sum of every call */
+		uint32_t calls;									/**< Number of calls */
+		uint32_t minCycles;								/**< Fastest call */
+		uint32_t maxCycles;								/**< Slowest call */
+		uint32_t buckets[PROFILE_HISTOGRAM_BUCKETS];	/**< Calls per power of two of cycles */
+	} WINDOW;
+
+	/** Component names, as published */
+	char names[MAX_PROFILED_COMPONENTS][PROFILE_NAME_LENGTH];
+	/** Current window of each component's step() */
+	WINDOW stepWindows[MAX_PROFILED_COMPONENTS];
+	/** Current window of each component's reportStatus() */
+	WINDOW reportWindows[MAX_PROFILED_COMPONENTS];
+	/** Number of registered components */
+	int numberOfComponents;
+	/** Ticks into the current window */
+	unsigned int ticks;
+	/** Number of windows completed */
+	unsigned int window;
+	/** Calibrated length of a cycle */
+	double nsPerCycle;
+
+	static inline void record(WINDOW *window, uint64_t cycles) {
+		uint32_t sample = cycles > UINT32_MAX ? UINT32_MAX : (uint32_t) cycles;
+		window->totalCycles += sample;
+		window->calls++;
+		if (sample < window->minCycles) {
+			window->minCycles = sample;
+		}
+		if (sample > window->maxCycles) {
+			window->maxCycles = sample;
+		}
+		window->buckets[sample == 0 ? 0 : 32 - __builtin_clz(sample) - 1]++;
+	}
+
+	/**
+	 * @fn summarize
+	 * @brief Convert a closed window to nanoseconds and reset it.
+	 */
+	void summarize(WINDOW *window, PROFILE_STATS *stats);
+
+public:
+	/**
+	 * @brief Calibrates the cycle counter, which takes about 10 ms.
+	 */
+	ComponentProfiler();
+	virtual ~ComponentProfiler();
+
+	/**
+	 * @fn add
+	 * @brief Register the next component, components must be added in tick order.
+	 * @param[in] name The name to publish, truncated to #PROFILE_NAME_LENGTH.
+	 * @return The component's index, or -1 if #MAX_PROFILED_COMPONENTS are already profiled.
+	 */
+	int add(const char *name);
+
+	/**
+	 * @fn getName
+	 * @param[in] component The index returned by #add.
+	 * @return The name the component is published under.
+	 */
+	inline const char *getName(int component) {
+		return component >= 0 && component < numberOfComponents ? names[component] : "(unprofiled)";
+	}
+
+	/**
+	 * @fn recordStep
+	 * @param[in] component The index returned by #add.
+	 * @param[in] cycles The duration of the component's step(), from #readCycleCounter.
+	 */
+	inline void recordStep(unsigned int component, uint64_t cycles) {
+		if (component < (unsigned int) numberOfComponents) {
+			record(&stepWindows[component], cycles);
+		}
+	}
+
+	/**
+	 * @fn recordReport
+	 * @param[in] component The index returned by #add.
+	 * @param[in] cycles The duration of the component's reportStatus(), from #readCycleCounter.
+	 */
+	inline void recordReport(unsigned int component, uint64_t cycles) {
+		if (component < (unsigned int) numberOfComponents) {
+			record(&reportWindows[component], cycles);
+		}
+	}
+
+	/**
+	 * @fn endTick
+	 * @brief Close the window every #PROFILE_WINDOW_TICKS ticks and publish it.
+	 * @param[out] profiles The #COMPONENT_PROFILES of #ROBOT_OUT, only written when a window closes.
+	 */
+	void endTick(COMPONENT_PROFILES *profiles);
+};
+
+#endif /* SRC_UTILITIES_COMPONENTPROFILER_H_ */
@@ -0,0 +1,40 @@
+#include "ComponentRegistry.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+#include "../Hardware/Motors/MotorFactory.h"
+
+ComponentRegistry::ComponentRegistry(ComponentScheduler *scheduler) : scheduler(scheduler) {
+}
+
+ComponentRegistry::~ComponentRegistry() {
+	for (const MOTOR_ENTRY &entry : motors) {
+		delete entry.motor;
+	}
+}
+
+MotorInterface *ComponentRegistry::getMotor(bool simulate, MOTOR_CONFIG *motorConfig) {
+	for (const MOTOR_ENTRY &entry : motors) {
+		if (entry.motorNumber == motorConfig->motorNumber) {
+			return entry.motor;
+		}
+	}
+	MOTOR_ENTRY entry;
+	entry.motorNumber = motorConfig->motorNumber;
+	entry.motor = MotorFactory::create(simulate, motorConfig);
+	motors.push_back(entry);
+	char name[PROFILE_NAME_LENGTH];
+	snprintf(name, PROFILE_NAME_LENGTH, "Motor %d", motorConfig->motorNumber);
+	add(entry.motor, name);
+	return entry.motor;
+}
+
+bool ComponentRegistry::add(ComponentInterface *component, const char *name) {
+	if (std::find(components.begin(), components.end(), component) != components.end()) {
+		return false;
+	}
+	components.push_back(component);
+	scheduler->add(component, name);
+	return true;
+}
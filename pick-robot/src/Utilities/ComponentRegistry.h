@@ -0,0 +1,81 @@
+#ifndef SRC_UTILITIES_COMPONENTREGISTRY_H_
+#define SRC_UTILITIES_COMPONENTREGISTRY_H_
+
+/**
+ * @file ComponentRegistry.h
+ */
+
+#include <ConfigStruct.h>
+#include <vector>
+
+#include "ComponentScheduler.h"
+#include "../Hardware/Motors/MotorInterface.h"
+
+/**
+ * @class ComponentRegistry
+ * @brief Schedules every component exactly once.
+ *
+ * Each motor number maps to exactly one #MotorInterface, owned by the registry and
+ * 	scheduled under its own name the first time it is requested. #Axis and
+ * 	#MotorController only keep references to the registered instances, so no
+ * 	driver is set up or polled twice.
+ */
+class ComponentRegistry {
+private:
+	/** A registered motor */
+	typedef struct {
+		int motorNumber;			/**< The SlushEngine motor number */
+		MotorInterface *motor;		/**< The only instance driving it */
+	} MOTOR_ENTRY;
+
+	/** Registered motors, owned by the registry */
+	std::vector<MOTOR_ENTRY> motors;
+	/** Every scheduled component, in the order added */
+	std::vector<ComponentInterface *> components;
+	/** Steps the registered components */
+	ComponentScheduler *scheduler;
+
+public:
+	/**
+	 * @param[in] scheduler Steps every registered component.
+	 */
+	ComponentRegistry(ComponentScheduler *scheduler);
+	virtual ~ComponentRegistry();
+
+	/**
+	 * @fn getMotor
+	 * @brief The motor driving @p motorConfig->motorNumber, created and scheduled on first use.
+	 * @param[in] simulate Whether a new motor is simulated.
+	 * @param[in] motorConfig How a new motor is configured.
+	 * @return The motor, shared by every caller asking for the same motor number.
+	 */
+	MotorInterface *getMotor(bool simulate, MOTOR_CONFIG *motorConfig);
+
+	/**
+	 * @fn getNumberOfMotors
+	 * @return The number of motors created.
+	 */
+	unsigned int getNumberOfMotors() {
+		return motors.size();
+	}
+
+	/**
+	 * @fn getMotorAt
+	 * @param[in] index Creation order, below #getNumberOfMotors.
+	 * @return The motor.
+	 */
+	MotorInterface *getMotorAt(unsigned int index) {
+		return motors[index].motor;
+	}
+
+	/**
+	 * @fn add
+	 * @brief Schedule a component, unless it is already registered. The caller keeps ownership.
+	 * @param[in] component The component.
+	 * @param[in] name The name the component is profiled under.
+	 * @return Whether the component was newly registered.
+	 */
+	bool add(ComponentInterface *component, const char *name);
+};
+
+#endif /* SRC_UTILITIES_COMPONENTREGISTRY_H_ */
@@ -0,0 +1,135 @@
+#include "ComponentScheduler.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+static unsigned int greatestCommonDivisor(unsigned int a, unsigned int b) {
+	while (b != 0) {
+		unsigned int remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+	return a;
+}
+
+ComponentScheduler::ComponentScheduler(ComponentProfiler *profiler) : profiler(profiler) {
+	worstTickUs = 0;
+}
+
+ComponentScheduler::~ComponentScheduler() {
+}
+
+void ComponentScheduler::add(ComponentInterface *component, const char *name) {
+	ENTRY entry;
+	entry.component = component;
+	entry.profile = profiler->add(name);
+	entry.period = std::max(component->getPeriod(), 1u);
+	entry.phase = 0;
+	entry.costUs = component->getStepCostUs();
+	entry.due = false;
+	entries.push_back(entry);
+}
+
+bool ComponentScheduler::plan(unsigned int budgetUs) {
+	unsigned long hyperperiod = 1;
+	for (const ENTRY &entry : entries) {
+		hyperperiod = hyperperiod / greatestCommonDivisor(hyperperiod, entry.period) * entry.period;
+		if (hyperperiod > SCHEDULE_MAX_HYPERPERIOD) {
+			printf("Schedule repeats after more than %d ticks, use periods with common factors.\n", SCHEDULE_MAX_HYPERPERIOD);
+			return false;
+		}
+	}
+
+	// Place fixed phases first, then the most expensive components where they raise the peak least
+	std::vector<unsigned int> order;
+	for (unsigned int index = 0; index < entries.size(); index++) {
+		order.push_back(index);
+	}
+	std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+		bool aFixed = entries[a].period == 1 || entries[a].component->getPhase() >= 0;
+		bool bFixed = entries[b].period == 1 || entries[b].component->getPhase() >= 0;
+		if (aFixed != bFixed) {
+			return aFixed;
+		}
+		return entries[a].costUs > entries[b].costUs;
+	});
+
+	std::vector<unsigned int> load(hyperperiod, 0);
+	for (unsigned int index : order) {
+		ENTRY *entry = &entries[index];
+		int phase = entry->component->getPhase();
+		if (entry->period == 1) {
+			entry->phase = 0;
+		} else if (phase >= 0) {
+			entry->phase = phase % entry->period;
+		} else {
+			unsigned int bestPeak = ~0u;
+			for (unsigned int candidate = 0; candidate < entry->period; candidate++) {
+				unsigned int peak = 0;
+				for (unsigned long tick = candidate; tick < hyperperiod; tick += entry->period) {
+					peak = std::max(peak, load[tick]);
+				}
+				if (peak < bestPeak) {
+					bestPeak = peak;
+					entry->phase = candidate;
+				}
+			}
+		}
+		for (unsigned long tick = entry->phase; tick < hyperperiod; tick += entry->period) {
+			load[tick] += entry->costUs;
+		}
+	}
+	worstTickUs = *std::max_element(load.begin(), load.end());
+
+	printf("Component schedule, repeating every %lu ticks:\n", hyperperiod);
+	for (const ENTRY &entry : entries) {
+		printf("  %-16s every %3u ticks, phase %3u, %4u us\n", profiler->getName(entry.profile),
+				entry.period, entry.phase, entry.costUs);
+	}
+	bool fits = worstTickUs <= budgetUs;
+	printf("Busiest tick: %u us of %u us budget: %s\n", worstTickUs, budgetUs, fits ? "OK" : "EXCEEDED");
+	return fits;
+}
+
+bool ComponentScheduler::getSlot(const ComponentInterface *component, SCHEDULE_SLOT *slot) {
+	for (const ENTRY &entry : entries) {
+		if (entry.component == component) {
+			slot->profile = entry.profile;
+			slot->period = entry.period;
+			slot->phase = entry.phase;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ComponentScheduler::step(long long int clockTicks) {
+	uint64_t start = readCycleCounter();
+	for (ENTRY &entry : entries) {
+		entry.due = clockTicks % entry.period == entry.phase;
+		if (entry.due) {
+			entry.component->step(clockTicks);
+			uint64_t end = readCycleCounter();
+			profiler->recordStep(entry.profile, end - start);
+			start = end;
+		}
+	}
+}
+
+void ComponentScheduler::reportStatus(void *robotOut) {
+	uint64_t start = readCycleCounter();
+	for (ENTRY &entry : entries) {
+		if (entry.due) {
+			entry.component->reportStatus(robotOut);
+			uint64_t end = readCycleCounter();
+			profiler->recordReport(entry.profile, end - start);
+			start = end;
+		}
+	}
+}
+
+void ComponentScheduler::emergencyStop() {
+	for (ENTRY &entry : entries) {
+		entry.component->emergencyStop();
+	}
+}
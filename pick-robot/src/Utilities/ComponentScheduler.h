@@ -0,0 +1,123 @@
+#ifndef SRC_UTILITIES_COMPONENTSCHEDULER_H_
+#define SRC_UTILITIES_COMPONENTSCHEDULER_H_
+
+/**
+ * @file ComponentScheduler.h
+ */
+
+#include <vector>
+
+#include "ComponentInterface.h"
+#include "ComponentProfiler.h"
+
+/** Longest schedule, in ticks, that is checked against the tick budget. */
+#define SCHEDULE_MAX_HYPERPERIOD 1000
+
+/**
+ * @typedef SCHEDULE_SLOT
+ * @brief When a component runs and where it is profiled, from ComponentScheduler::plan.
+ */
+typedef struct {
+	int profile;			/**< Index returned by ComponentProfiler::add */
+	unsigned int period;	/**< Ticks between calls */
+	unsigned int phase;		/**< Tick, modulo #period, the component runs on */
+} SCHEDULE_SLOT;
+
+/**
+ * @class ComponentScheduler
+ * @brief Runs each component every #ComponentInterface::getPeriod ticks.
+ *
+ * Components without a fixed #ComponentInterface::getPhase are spread across
+ * 	their period so the worst case bus time of the busiest tick is as low as
+ * 	possible. #plan checks that busiest tick against the tick budget once at
+ * 	startup, #step and #reportStatus only call the components due this tick.
+ */
+class ComponentScheduler {
+private:
+	/** A scheduled component */
+	typedef struct {
+		ComponentInterface *component;	/**< The component */
+		int profile;					/**< Index returned by ComponentProfiler::add */
+		unsigned int period;			/**< Ticks between calls */
+		unsigned int phase;				/**< Tick, modulo #period, the component runs on */
+		unsigned int costUs;			/**< Worst case duration of a call */
+		bool due;						/**< Whether the component stepped this tick */
+	} ENTRY;
+
+	/** Components in the order they step */
+	std::vector<ENTRY> entries;
+	/** Times every call */
+	ComponentProfiler *profiler;
+	/** Worst case duration of the busiest tick, from #plan */
+	unsigned int worstTickUs;
+
+public:
+	/**
+	 * @param[in] profiler Times every #step and #reportStatus call.
+	 */
+	ComponentScheduler(ComponentProfiler *profiler);
+	virtual ~ComponentScheduler();
+
+	/**
+	 * @fn add
+	 * @brief Add a component, components due on the same tick step in the order they are added.
+	 * @param[in] component The component.
+	 * @param[in] name The name the component is profiled under.
+	 */
+	void add(ComponentInterface *component, const char *name);
+
+	/**
+	 * @fn plan
+	 * @brief Assign phases, print the schedule and validate it. Call once, after every #add.
+	 * @param[in] budgetUs Component time allowed per tick.
+	 * @return Whether the busiest tick fits in @p budgetUs.
+	 */
+	bool plan(unsigned int budgetUs);
+
+	/**
+	 * @fn getWorstTickUs
+	 * @return The worst case component time of the busiest tick.
+	 */
+	unsigned int getWorstTickUs() {
+		return worstTickUs;
+	}
+
+	/**
+	 * @fn getNumberOfComponents
+	 * @return The number of components added.
+	 */
+	unsigned int getNumberOfComponents() {
+		return entries.size();
+	}
+
+	/**
+	 * @fn getSlot
+	 * @brief Look up a component's planned slot, for pipelines that step it directly.
+	 * @param[in] component The component.
+	 * @param[out] slot Its slot.
+	 * @return Whether @p component was added.
+	 */
+	bool getSlot(const ComponentInterface *component, SCHEDULE_SLOT *slot);
+
+	/**
+	 * @fn step
+	 * @brief Step the components due on @p clockTicks.
+	 * @param[in] clockTicks The current clock tick in milliseconds.
+	 */
+	void step(long long int clockTicks);
+
+	/**
+	 * @fn reportStatus
+	 * @brief Report the components that stepped this tick. The others' last report stays in @p robotOut.
+	 * @param[out] robotOut The #ROBOT_OUT being built.
+	 */
+	void reportStatus(void *robotOut);
+
+	/**
+	 * @fn emergencyStop
+	 * @brief Stop every component, whether or not it is due.
+	 */
+	void emergencyStop();
+};
+
+#endif /* SRC_UTILITIES_COMPONENTSCHEDULER_H_ */
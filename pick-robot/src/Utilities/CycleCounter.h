@@ -0,0 +1,57 @@
+#ifndef SRC_UTILITIES_CYCLECOUNTER_H_
+#define SRC_UTILITIES_CYCLECOUNTER_H_
+
+/**
+ * @file CycleCounter.h
+ * @brief Cheapest monotonic counter readable from user space.
+ *
+ * On the Raspberry Pi this is the ARM generic timer's virtual count (CNTVCT),
+ * 	which Linux exposes to user space for the vDSO. On x86 hosts it is the TSC.
+ * 	Anywhere else it falls back to CLOCK_MONOTONIC in nanoseconds. Use
+ * 	#cycleCounterFrequency to convert counts to time.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @fn readCycleCounter
+ * @return The current count.
+ */
+static inline uint64_t readCycleCounter() {
+#if defined(__aarch64__)
+	uint64_t count;
+	asm volatile ("isb; mrs %0, cntvct_el0" : "=r" (count) :: "memory");
+	return count;
+#elif defined(__arm__)
+	uint64_t count;
+	asm volatile ("isb; mrrc p15, 1, %Q0, %R0, c14" : "=r" (count) :: "memory");
+	return count;
+#elif defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+/**
+ * @fn cycleCounterFrequency
+ * @brief Calibrate #readCycleCounter against CLOCK_MONOTONIC. Sleeps for
+ * 	about 10 ms, call once at startup.
+ * @return Counts per second.
+ */
+static inline double cycleCounterFrequency() {
+	struct timespec start, end;
+	struct timespec calibration = { 0, 10000000L };
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	uint64_t startCount = readCycleCounter();
+	nanosleep(&calibration, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	uint64_t endCount = readCycleCounter();
+	double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	return (endCount - startCount) / seconds;
+}
+
+#endif /* SRC_UTILITIES_CYCLECOUNTER_H_ */
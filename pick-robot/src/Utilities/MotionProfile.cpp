@@ -0,0 +1,141 @@
+#include "MotionProfile.h"
+
+#include <algorithm>
+#include <cmath>
+
+static double sign(double value) {
+	return (value > 0) - (value < 0);
+}
+
+MotionProfile::MotionProfile() {
+	maxSpeed = 0;
+	acceleration = 0;
+	deceleration = 0;
+	numberOfPhases = 0;
+	target = 0;
+	duration = 0;
+}
+
+void MotionProfile::configure(double maxSpeed, double acceleration, double deceleration) {
+	this->maxSpeed = std::fabs(maxSpeed);
+	this->acceleration = std::max(acceleration, 0.0);
+	this->deceleration = std::max(deceleration, 0.0);
+}
+
+void MotionProfile::addPhase(double phaseDuration, double &position, double &speed, double phaseAcceleration) {
+	if (phaseDuration <= 0 || numberOfPhases >= MOTION_MAX_PHASES) {
+		return;
+	}
+	PHASE *phase = &phases[numberOfPhases++];
+	phase->duration = phaseDuration;
+	phase->position = position;
+	phase->speed = speed;
+	phase->acceleration = phaseAcceleration;
+	position += speed * phaseDuration + phaseAcceleration * phaseDuration * phaseDuration / 2;
+	speed += phaseAcceleration * phaseDuration;
+	duration += phaseDuration;
+}
+
+double MotionProfile::stoppingDistance(double speed) {
+	return deceleration > 0 ? speed * speed / (2 * deceleration) : 0;
+}
+
+void MotionProfile::plan(double position, double speed, double target) {
+	this->numberOfPhases = 0;
+	this->duration = 0;
+	this->target = target;
+	if (maxSpeed <= 0) {
+		return;
+	}
+
+	// Stop first when heading away from the target or too fast to stop on it
+	double direction = sign(target - position);
+	if (speed != 0 && (sign(speed) != direction || stoppingDistance(speed) > std::fabs(target - position))) {
+		addPhase(deceleration > 0 ? std::fabs(speed) / deceleration : 0, position, speed, -sign(speed) * deceleration);
+		speed = 0;
+		direction = sign(target - position);
+	}
+	double distance = std::fabs(target - position);
+	double startSpeed = std::fabs(speed);
+	if (distance == 0) {
+		return;
+	}
+	// A lowered max speed is reached by decelerating
+	if (startSpeed > maxSpeed) {
+		double slowing = deceleration > 0 ? (startSpeed - maxSpeed) / deceleration : 0;
+		addPhase(slowing, position, speed, -direction * deceleration);
+		distance = std::fabs(target - position);
+		startSpeed = maxSpeed;
+	}
+	speed = direction * startSpeed;
+
+	// Peak speed where accelerating and then decelerating covers the distance exactly
+	double accelerationTerm = acceleration > 0 ? 1 / (2 * acceleration) : 0;
+	double decelerationTerm = deceleration > 0 ? 1 / (2 * deceleration) : 0;
+	double peakSpeed = maxSpeed;
+	if (accelerationTerm + decelerationTerm > 0) {
+		peakSpeed = std::min(maxSpeed, std::sqrt((distance + startSpeed * startSpeed * accelerationTerm)
+				/ (accelerationTerm + decelerationTerm)));
+		peakSpeed = std::max(peakSpeed, startSpeed);
+	}
+	double accelerating = (peakSpeed * peakSpeed - startSpeed * startSpeed) * accelerationTerm;
+	double decelerating = peakSpeed * peakSpeed * decelerationTerm;
+	double cruising = std::max(distance - accelerating - decelerating, 0.0);
+
+	addPhase(acceleration > 0 ? (peakSpeed - startSpeed) / acceleration : 0, position, speed, direction * acceleration);
+	speed = direction * peakSpeed;
+	addPhase(cruising / peakSpeed, position, speed, 0);
+	addPhase(deceleration > 0 ? peakSpeed / deceleration : 0, position, speed, -direction * deceleration);
+}
+
+void MotionProfile::planStop(double position, double speed) {
+	plan(position, speed, position + sign(speed) * stoppingDistance(speed));
+}
+
+double MotionProfile::getPositionAt(double seconds) {
+	for (unsigned int i = 0; i < numberOfPhases; i++) {
+		const PHASE &phase = phases[i];
+		if (seconds < phase.duration) {
+			return phase.position + phase.speed * seconds + phase.acceleration * seconds * seconds / 2;
+		}
+		seconds -= phase.duration;
+	}
+	return target;
+}
+
+double MotionProfile::getSpeedAt(double seconds) {
+	for (unsigned int i = 0; i < numberOfPhases; i++) {
+		const PHASE &phase = phases[i];
+		if (seconds < phase.duration) {
+			return phase.speed + phase.acceleration * seconds;
+		}
+		seconds -= phase.duration;
+	}
+	return 0;
+}
+
+double MotionProfile::getTravelTime(double distance, double maxSpeed, double acceleration, double deceleration) {
+	MotionProfile profile;
+	profile.configure(maxSpeed, acceleration, deceleration);
+	profile.plan(0, 0, std::fabs(distance));
+	return profile.getDuration();
+}
+
+double MotionProfile::getCruiseSpeedFor(double distance, double seconds, double maxSpeed, double acceleration,
+		double deceleration) {
+	distance = std::fabs(distance);
+	if (distance == 0 || seconds <= 0) {
+		return maxSpeed;
+	}
+	// seconds = distance / v + v * k for a trapezoid cruising at v, take the slower root
+	double k = (acceleration > 0 ? 1 / (2 * acceleration) : 0) + (deceleration > 0 ? 1 / (2 * deceleration) : 0);
+	double speed;
+	if (k == 0) {
+		speed = distance / seconds;
+	} else {
+		double discriminant = seconds * seconds - 4 * k * distance;
+		// No trapezoid is that quick, cruise at the peak of the quickest triangle
+		speed = discriminant < 0 ? std::sqrt(distance / k) : (seconds - std::sqrt(discriminant)) / (2 * k);
+	}
+	return std::min(speed, maxSpeed);
+}
@@ -0,0 +1,131 @@
+#ifndef SRC_UTILITIES_MOTIONPROFILE_H_
+#define SRC_UTILITIES_MOTIONPROFILE_H_
+
+/**
+ * @file MotionProfile.h
+ */
+
+/** Most phases a planned move has: stop, slow to max speed, accelerate, cruise, decelerate. */
+#define MOTION_MAX_PHASES 5
+
+/**
+ * @class MotionProfile
+ * @brief The L6470 trapezoidal speed profile of one move.
+ *
+ * A move accelerates at #acceleration to at most #maxSpeed, cruises, then decelerates
+ * 	at #deceleration to stop on the target. Moves planned while already moving start
+ * 	from that speed, first stopping if it points away from the target or is too fast
+ * 	to stop in time. An acceleration or deceleration that is not positive is instant.
+ *
+ * Units are whatever the caller uses, steps or millimeters, per second.
+ * 	Planning and queries never allocate.
+ */
+class MotionProfile {
+private:
+	/** A stretch of constant acceleration */
+	typedef struct {
+		double duration;		/**< Seconds */
+		double position;		/**< Position at the start */
+		double speed;			/**< Signed speed at the start */
+		double acceleration;	/**< Signed acceleration */
+	} PHASE;
+
+	/** Fastest cruise speed */
+	double maxSpeed;
+	/** Speeding up, 0 if instant */
+	double acceleration;
+	/** Slowing down, 0 if instant */
+	double deceleration;
+
+	/** The planned phases */
+	PHASE phases[MOTION_MAX_PHASES];
+	/** Number of planned phases */
+	unsigned int numberOfPhases;
+	/** Where the move ends */
+	double target;
+	/** Seconds the move takes */
+	double duration;
+
+	void addPhase(double phaseDuration, double &position, double &speed, double phaseAcceleration);
+	double stoppingDistance(double speed);
+
+public:
+	/**
+	 * Sets:
+	 * 		- every limit : 0
+	 * 		- #target : 0, already reached
+	 */
+	MotionProfile();
+
+	/**
+	 * @fn configure
+	 * @brief Set the limits used by the next #plan.
+	 * @param[in] maxSpeed Fastest cruise speed, units/second.
+	 * @param[in] acceleration Units/second², instant if not positive.
+	 * @param[in] deceleration Units/second², instant if not positive.
+	 */
+	void configure(double maxSpeed, double acceleration, double deceleration);
+
+	/**
+	 * @fn plan
+	 * @brief Plan the move to @p target.
+	 * @param[in] position Where the move starts.
+	 * @param[in] speed Signed speed at the start.
+	 * @param[in] target Where the move ends.
+	 */
+	void plan(double position, double speed, double target);
+
+	/**
+	 * @fn planStop
+	 * @brief Plan decelerating to a stop, like the L6470 SoftStop.
+	 * @param[in] position Where the motor is.
+	 * @param[in] speed Signed speed of the motor.
+	 */
+	void planStop(double position, double speed);
+
+	/**
+	 * @fn getDuration
+	 * @return Seconds from the start of the move until it reaches its target.
+	 */
+	double getDuration() {
+		return duration;
+	}
+
+	/**
+	 * @fn getTarget
+	 * @return Where the move ends.
+	 */
+	double getTarget() {
+		return target;
+	}
+
+	/**
+	 * @fn getPositionAt
+	 * @param[in] seconds Time since the start of the move.
+	 * @return The position then, the target once the move is over.
+	 */
+	double getPositionAt(double seconds);
+
+	/**
+	 * @fn getSpeedAt
+	 * @param[in] seconds Time since the start of the move.
+	 * @return The signed speed then, 0 once the move is over.
+	 */
+	double getSpeedAt(double seconds);
+
+	/**
+	 * @fn getTravelTime
+	 * @brief Seconds a move of @p distance takes from and to a standstill.
+	 */
+	static double getTravelTime(double distance, double maxSpeed, double acceleration, double deceleration);
+
+	/**
+	 * @fn getCruiseSpeedFor
+	 * @brief The cruise speed that makes a move of @p distance from a standstill take @p seconds.
+	 * @return At most @p maxSpeed, so moves that can't be that quick take longer.
+	 */
+	static double getCruiseSpeedFor(double distance, double seconds, double maxSpeed, double acceleration,
+			double deceleration);
+};
+
+#endif /* SRC_UTILITIES_MOTIONPROFILE_H_ */
@@ -0,0 +1,133 @@
+#include "PositionSnapshot.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/** FNV-1a, 32 bit */
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static uint32_t fnv(uint32_t hash, const void *data, size_t size) {
+	const unsigned char *bytes = (const unsigned char *) data;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+PositionSnapshot::PositionSnapshot() {
+	segment = NULL;
+	hasLoaded = false;
+	memset(&loaded, 0, sizeof(POSITION_RECORD));
+	memset(&last, 0, sizeof(POSITION_RECORD));
+
+	int md = shm_open("robot_position", O_CREAT | O_RDWR, 0666);
+	if (md == -1 || ftruncate(md, sizeof(POSITION_SNAPSHOT_SEGMENT)) == -1) {
+		perror("Position snapshot unavailable");
+		if (md != -1) {
+			close(md);
+		}
+		return;
+	}
+	void *address = mmap(0, sizeof(POSITION_SNAPSHOT_SEGMENT), PROT_WRITE | PROT_READ, MAP_SHARED, md, 0);
+	close(md);
+	if (address == MAP_FAILED) {
+		perror("Position snapshot unavailable");
+		return;
+	}
+	segment = (POSITION_SNAPSHOT_SEGMENT *) address;
+	if (segment->magic != POSITION_SNAPSHOT_MAGIC) {
+		memset(segment, 0, sizeof(POSITION_SNAPSHOT_SEGMENT));
+		segment->magic = POSITION_SNAPSHOT_MAGIC;
+		return;
+	}
+	for (int i = 0; i < 2; i++) {
+		const POSITION_RECORD *record = &segment->records[i];
+		if (record->checksum == checksum(record) && (!hasLoaded || (int32_t) (record->sequence - loaded.sequence) > 0)) {
+			loaded = *record;
+			hasLoaded = true;
+		}
+	}
+	last = loaded;
+}
+
+PositionSnapshot::~PositionSnapshot() {
+	if (segment != NULL) {
+		munmap(segment, sizeof(POSITION_SNAPSHOT_SEGMENT));
+	}
+}
+
+uint32_t PositionSnapshot::checksum(const POSITION_RECORD *record) {
+	return fnv(FNV_OFFSET_BASIS, record, offsetof(POSITION_RECORD, checksum));
+}
+
+uint32_t PositionSnapshot::getGeometry(const AXIS_CONFIG *axes) {
+	uint32_t hash = FNV_OFFSET_BASIS;
+	for (int i = 0; i < NUM_AXES; i++) {
+		const AXIS_CONFIG *axis = &axes[i];
+		if (!axis->valid) {
+			continue;
+		}
+		hash = fnv(hash, &axis->axisLabel, sizeof(axis->axisLabel));
+		hash = fnv(hash, &axis->travelLimitmm, sizeof(axis->travelLimitmm));
+		for (int j = 0; j < MAX_MOTORS_PER_AXIS; j++) {
+			const MOTOR_CONFIG *motor = &axis->motor[j];
+			if (!motor->valid) {
+				continue;
+			}
+			hash = fnv(hash, &motor->motorNumber, sizeof(motor->motorNumber));
+			hash = fnv(hash, &motor->stepsPerRev, sizeof(motor->stepsPerRev));
+			hash = fnv(hash, &motor->mmPerRev, sizeof(motor->mmPerRev));
+			hash = fnv(hash, &motor->invert, sizeof(motor->invert));
+		}
+	}
+	return hash;
+}
+
+bool PositionSnapshot::canResume(const std::array<Axis *, NUM_AXES> &axes, uint32_t geometry) {
+	if (!hasLoaded || !loaded.homed || !loaded.atRest || loaded.geometry != geometry) {
+		return false;
+	}
+	for (int i = 0; i < NUM_AXES; i++) {
+		const MotorSpan &motors = axes[i]->getMotorObj();
+		for (unsigned int j = 0; j < motors.size(); j++) {
+			// A driver that lost power or let go of its motor can't vouch for where it is
+			if (!motors.motors[j]->hasRetainedPosition()
+					|| motors.motors[j]->getPositionInSteps() != loaded.positions[i][j]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void PositionSnapshot::write(const std::array<Axis *, NUM_AXES> &axes, uint32_t geometry, bool homed, bool atRest) {
+	if (segment == NULL) {
+		return;
+	}
+	POSITION_RECORD record;
+	// Zero the padding too, the checksum covers it
+	memset(&record, 0, sizeof(POSITION_RECORD));
+	record.geometry = geometry;
+	record.homed = homed;
+	record.atRest = atRest;
+	for (int i = 0; i < NUM_AXES; i++) {
+		const MotorSpan &motors = axes[i]->getMotorObj();
+		for (unsigned int j = 0; j < motors.size(); j++) {
+			record.positions[i][j] = motors.motors[j]->getPositionInSteps();
+		}
+	}
+	record.sequence = last.sequence;
+	if (memcmp(&record, &last, offsetof(POSITION_RECORD, checksum)) == 0) {
+		return;
+	}
+	record.sequence = last.sequence + 1;
+	record.checksum = checksum(&record);
+	// Overwrite the older record, the newer one stays intact until this one is complete
+	segment->records[record.sequence & 1] = record;
+	last = record;
+}
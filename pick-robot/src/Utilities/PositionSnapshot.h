@@ -0,0 +1,106 @@
+#ifndef SRC_UTILITIES_POSITIONSNAPSHOT_H_
+#define SRC_UTILITIES_POSITIONSNAPSHOT_H_
+
+/**
+ * @file PositionSnapshot.h
+ */
+
+#include <ConfigStruct.h>
+#include <stdint.h>
+#include <array>
+
+#include "Axis.h"
+
+/** Identifies a #POSITION_SNAPSHOT_SEGMENT, bumped whenever its layout changes. */
+#define POSITION_SNAPSHOT_MAGIC 0x50534E01
+
+/**
+ * @typedef POSITION_RECORD
+ * @brief Where the motors were and whether that is relative to home.
+ */
+typedef struct {
+	uint32_t sequence;									/**< Records written, the newest valid one wins */
+	uint32_t geometry;									/**< PositionSnapshot::getGeometry of the configuration in use */
+	bool homed;											/**< The positions count from a completed zero return */
+	bool atRest;										/**< Every axis had reached its target */
+	int32_t positions[NUM_AXES][MAX_MOTORS_PER_AXIS];	/**< MotorInterface::getPositionInSteps of each axis motor */
+	uint32_t checksum;									/**< Of every field above, a torn write doesn't match */
+} POSITION_RECORD;
+
+/**
+ * @typedef POSITION_SNAPSHOT_SEGMENT
+ * @brief Two alternating #POSITION_RECORD, a write only touches the older one.
+ */
+typedef struct {
+	uint32_t magic;						/**< #POSITION_SNAPSHOT_MAGIC once initialised */
+	POSITION_RECORD records[2];			/**< Indexed by #POSITION_RECORD::sequence parity */
+} POSITION_SNAPSHOT_SEGMENT;
+
+/**
+ * @class PositionSnapshot
+ * @brief The last known motor positions, kept across restarts of the Pick-Robot.
+ *
+ * The record lives in a shared memory object, so it outlives the process but not a
+ * 	reboot. Writes are plain stores into the mapping, they never block the real-time
+ * 	loop and reach the page cache even if the process dies right after. A write that
+ * 	is cut short leaves a record whose checksum doesn't match, and the previous record
+ * 	is used instead.
+ *
+ * A record alone never proves the machine is still homed: #canResume also requires
+ * 	every motor's driver to have kept power and holding torque since, and to still
+ * 	be exactly where the record says it stopped.
+ */
+class PositionSnapshot {
+private:
+	/** The mapped #POSITION_SNAPSHOT_SEGMENT, NULL if it could not be mapped */
+	POSITION_SNAPSHOT_SEGMENT *segment;
+	/** The newest valid record when the snapshot was opened */
+	POSITION_RECORD loaded;
+	/** Whether #loaded is valid */
+	bool hasLoaded;
+	/** The last record written */
+	POSITION_RECORD last;
+
+	static uint32_t checksum(const POSITION_RECORD *record);
+
+public:
+	/**
+	 * @brief Map the snapshot and load its newest valid record.
+	 */
+	PositionSnapshot();
+	virtual ~PositionSnapshot();
+
+	/**
+	 * @fn getGeometry
+	 * @brief A hash of everything in @p axes that relates motor steps to axis positions.
+	 *
+	 * Labels, travel limits and each motor's number, steps/revolution, mm/revolution and
+	 * 	inversion. Speeds, currents and staging areas are left out, they don't move home.
+	 * @param[in] axes The #JSON_CONFIG::axes.
+	 */
+	static uint32_t getGeometry(const AXIS_CONFIG *axes);
+
+	/**
+	 * @fn canResume
+	 * @brief Whether the loaded record proves @p axes are still homed.
+	 *
+	 * The record must be homed, at rest and from the same geometry, every motor must
+	 * 	have retained its position (see MotorInterface::hasRetainedPosition) and be
+	 * 	exactly at its recorded position.
+	 * @param[in] axes The axes, in #AXIS order.
+	 * @param[in] geometry #getGeometry of the configuration in use.
+	 */
+	bool canResume(const std::array<Axis *, NUM_AXES> &axes, uint32_t geometry);
+
+	/**
+	 * @fn write
+	 * @brief Record the motor positions, only touching the mapping if anything changed.
+	 * @param[in] axes The axes, in #AXIS order.
+	 * @param[in] geometry #getGeometry of the configuration in use.
+	 * @param[in] homed Whether the positions count from a completed zero return.
+	 * @param[in] atRest Whether every axis has reached its target.
+	 */
+	void write(const std::array<Axis *, NUM_AXES> &axes, uint32_t geometry, bool homed, bool atRest);
+};
+
+#endif /* SRC_UTILITIES_POSITIONSNAPSHOT_H_ */
@@ -6,18 +6,37 @@
  */
 
 #include "SharedMemory.h"
+
+#include <CommandRing.h>
+#include <TelemetryHistory.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <fcntl.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-SharedMemory::SharedMemory() {
+/** Longest segment name, prefix included */
+#define SHM_NAME_LENGTH 32
+
+void SharedMemory::segmentName(char *name, const char *segment) {
+	snprintf(name, SHM_NAME_LENGTH, "%s_%s", prefix, segment);
+}
+
+SharedMemory::SharedMemory(const char *prefix) {
+	char name[SHM_NAME_LENGTH];
+	this->prefix = prefix;
+	tornReads = 0;
+	commandsProcessed = 0;
+	historyRecords = 0;
+	commandSequence = 0;
+	memset(&published, 0, sizeof(ROBOT_OUT));
 	pg_size = sysconf(_SC_PAGE_SIZE);
 	/* Create shared memory object */
-	robot_in_md = shm_open("robot_in", O_CREAT | O_RDWR, 0666);
+	segmentName(name, "in");
+	robot_in_md = shm_open(name, O_CREAT | O_RDWR, 0666);
 
 
 	if ((ftruncate(robot_in_md, pg_size)) == -1) { /* Set the size */
@@ -33,7 +52,8 @@ SharedMemory::SharedMemory() {
 		exit(1);
 	}
 
-	robot_out_md = shm_open("robot_out", O_CREAT | O_RDWR, 0666);
+	segmentName(name, "out");
+	robot_out_md = shm_open(name, O_CREAT | O_RDWR, 0666);
 
 	if ((ftruncate(robot_out_md, pg_size)) == -1) { /* Set the size */
 		perror("ftruncate failure");
@@ -47,29 +67,129 @@ SharedMemory::SharedMemory() {
 		perror("mlock failure");
 		exit(1);
 	}
+
+	segmentName(name, "config");
+	robot_config_md = shm_open(name, O_CREAT | O_RDWR, 0666);
+
+	if ((ftruncate(robot_config_md, sizeof(ROBOT_CONFIG_SEGMENT))) == -1) { /* Set the size */
+		perror("ftruncate failure");
+		exit(1);
+	}
+	/* Map the configuration */
+	robot_config_addr = mmap(0, sizeof(ROBOT_CONFIG_SEGMENT), PROT_WRITE | PROT_READ, MAP_SHARED, robot_config_md, 0);
+	memset(robot_config_addr, 0, sizeof(ROBOT_CONFIG_SEGMENT));
+
+	if (mlock(robot_config_addr, sizeof(ROBOT_CONFIG_SEGMENT)) != 0) {
+		perror("mlock failure");
+		exit(1);
+	}
+
+	segmentName(name, "history");
+	robot_history_md = shm_open(name, O_CREAT | O_RDWR, 0666);
+
+	if ((ftruncate(robot_history_md, sizeof(TELEMETRY_HISTORY))) == -1) { /* Set the size */
+		perror("ftruncate failure");
+		exit(1);
+	}
+	/* Map the whole history, it is written every tick so keep it resident */
+	robot_history_addr = mmap(0, sizeof(TELEMETRY_HISTORY), PROT_WRITE | PROT_READ, MAP_SHARED, robot_history_md, 0);
+	memset(robot_history_addr, 0, sizeof(TELEMETRY_HISTORY));
+
+	if (mlock(robot_history_addr, sizeof(TELEMETRY_HISTORY)) != 0) {
+		perror("mlock failure");
+		exit(1);
+	}
 }
 
 SharedMemory::~SharedMemory() {
+	char name[SHM_NAME_LENGTH];
 	munmap(robot_in_addr, pg_size); /* Unmap the page */
 	close(robot_in_md); /*   Close file   */
-	shm_unlink("robot_in"); /* Unlink shared-memory object */
+	segmentName(name, "in");
+	shm_unlink(name); /* Unlink shared-memory object */
 	munmap(robot_out_addr, pg_size); /* Unmap the page */
 	close(robot_out_md); /*   Close file   */
-	shm_unlink("robot_out"); /* Unlink shared-memory object */
+	segmentName(name, "out");
+	shm_unlink(name); /* Unlink shared-memory object */
+	munmap(robot_config_addr, sizeof(ROBOT_CONFIG_SEGMENT)); /* Unmap the configuration */
+	close(robot_config_md); /*   Close file   */
+	segmentName(name, "config");
+	shm_unlink(name); /* Unlink shared-memory object */
+	munmap(robot_history_addr, sizeof(TELEMETRY_HISTORY)); /* Unmap the history */
+	close(robot_history_md); /*   Close file   */
+	segmentName(name, "history");
+	shm_unlink(name); /* Unlink shared-memory object */
 }
 
-bool SharedMemory::readRobotIn(ROBOT_IN *block) {
-	ROBOT_IN temp;
-	memcpy(&temp, robot_in_addr, sizeof(ROBOT_IN));
-	if (temp.block_number != block->block_number) {
-		memcpy(block, &temp, sizeof(ROBOT_IN));
-		return true;
+bool SharedMemory::readConfig(JSON_CONFIG *config) {
+	ROBOT_CONFIG_SEGMENT *segment = (ROBOT_CONFIG_SEGMENT *) robot_config_addr;
+	if (__atomic_load_n(&segment->hash, __ATOMIC_ACQUIRE) == config->hash) {
+		return false;
 	}
-	return false;
+	JSON_CONFIG temp;
+	if (!seqlockTryRead(&segment->lock, &temp, &segment->config, sizeof(JSON_CONFIG))) {
+		// Never wait on the Pick-Trigger-App, try again next tick
+		tornReads++;
+		return false;
+	}
+	memcpy(config, &temp, sizeof(JSON_CONFIG));
+	return true;
 }
 
 bool SharedMemory::writeRobotOut(ROBOT_OUT *status) {
-	memcpy(robot_out_addr, status, sizeof(ROBOT_OUT));
+	ROBOT_OUT_SEGMENT *segment = (ROBOT_OUT_SEGMENT *) robot_out_addr;
+	seqlockWrite(&segment->lock, &segment->block, status, sizeof(ROBOT_OUT));
+	// #ROBOT_OUT::ipcStatus and #ROBOT_OUT::block_number change every tick, don't wake for those
+	if (memcmp(&published, status, offsetof(ROBOT_OUT, ipcStatus)) != 0) {
+		memcpy(&published, status, sizeof(ROBOT_OUT));
+		sharedEventSignal(&segment->statusEvent);
+	}
 	return true;
 }
 
+
+void SharedMemory::appendTelemetry(ROBOT_OUT *status) {
+	TELEMETRY_RECORD record;
+	record.block_number = status->block_number;
+	memcpy(record.axisPosition, status->axisStatus.axisPosition, sizeof(record.axisPosition));
+	memcpy(record.targetPosition, status->axisStatus.targetPosition, sizeof(record.targetPosition));
+	record.itemsPicked = status->pc_status.itemsPicked;
+	record.sensorValue = status->vacStatus.sensorValue;
+	record.pickState = status->pc_status.state;
+	record.suctionStatus = status->vacStatus.suctionStatus;
+	record.priorityError = status->operatingErrors.priorityError;
+	record.isBusy = status->axisStatus.isBusy;
+	record.isVacuumOn = status->vacStatus.isVacuumOn;
+	record.emergencyStop = status->runtimeFlags.emergencyStop;
+	telemetryHistoryAppend((TELEMETRY_HISTORY *) robot_history_addr, &record);
+	historyRecords++;
+}
+
+unsigned int SharedMemory::pendingCommands() {
+	ROBOT_IN_SEGMENT *segment = (ROBOT_IN_SEGMENT *) robot_in_addr;
+	// Sampled first: anything queued after this point signals a later sequence
+	commandSequence = sharedEventSequence(&segment->commandEvent);
+	return commandRingPending(&segment->commands);
+}
+
+int SharedMemory::waitForCommand(const struct timespec *deadline) {
+	ROBOT_IN_SEGMENT *segment = (ROBOT_IN_SEGMENT *) robot_in_addr;
+	return sharedEventWait(&segment->commandEvent, commandSequence, deadline);
+}
+
+bool SharedMemory::popCommand(COMMAND_STRUCT *command) {
+	ROBOT_IN_SEGMENT *segment = (ROBOT_IN_SEGMENT *) robot_in_addr;
+	if (commandRingPop(&segment->commands, command)) {
+		commandsProcessed++;
+		return true;
+	}
+	return false;
+}
+
+void SharedMemory::reportStatus(IPC_STATUS *ipcStatus) {
+	ROBOT_IN_SEGMENT *segment = (ROBOT_IN_SEGMENT *) robot_in_addr;
+	ipcStatus->tornReads = tornReads;
+	ipcStatus->commandsProcessed = commandsProcessed;
+	ipcStatus->commandsDropped = __atomic_load_n(&segment->commands.dropped, __ATOMIC_RELAXED);
+	ipcStatus->historyRecords = historyRecords;
+}
@@ -26,27 +26,109 @@ private:
 	void* robot_in_addr;
 	/** Memory address of robot out */
 	void* robot_out_addr;
+	/** Memory descriptor for the configuration passed to the Pick-Robot */
+	int robot_config_md;
+	/** Memory address of the #ROBOT_CONFIG_SEGMENT */
+	void* robot_config_addr;
+	/** Number of #JSON_CONFIG snapshots discarded because the Pick-Trigger-App was mid-write */
+	long tornReads;
+	/** Number of commands popped from the #COMMAND_RING */
+	long commandsProcessed;
+	/** Memory descriptor for the #TELEMETRY_HISTORY passed to the Pick-Trigger-App */
+	int robot_history_md;
+	/** Memory address of the #TELEMETRY_HISTORY */
+	void* robot_history_addr;
+	/** Number of records appended to the #TELEMETRY_HISTORY */
+	long historyRecords;
+	/** The last #ROBOT_OUT the Pick-Trigger-App was woken for */
+	ROBOT_OUT published;
+	/** The #ROBOT_IN_SEGMENT::commandEvent sequence as of the last #pendingCommands */
+	unsigned int commandSequence;
+	/** Prefix of the segment names, `robot` for the ones the Pick-Trigger-App opens */
+	const char *prefix;
+
+	/**
+	 * @fn segmentName
+	 * @brief Write the name of @p segment, e.g. `robot_in` for `in`, into @p name.
+	 */
+	void segmentName(char *name, const char *segment);
 public:
 	/**
 	 * @brief Instance specific to the Pick-Robot.
+	 * @param[in] prefix Prefix of the segment names. Anything but the default
+	 * 	leaves a running Pick-Trigger-App's segments alone, e.g. for benchmarks.
 	 */
-	SharedMemory();
+	SharedMemory(const char *prefix = "robot");
 	virtual ~SharedMemory();
 
 	/**
-	 * @fn readRobotIn
-	 * @brief Read the passed information from either the config or
-	 * 	Pick-Trigger-App.
-	 * @param[in] ROBOT_IN Reference to #ROBOT_IN structure.
+	 * @fn readConfig
+	 * @brief Read the configuration published by the Pick-Trigger-App, if its hash
+	 * 	differs from @p config's.
+	 *
+	 * Costs a single load while the configuration is unchanged. Otherwise makes a
+	 * 	single, non-blocking attempt at a consistent snapshot. If the Pick-Trigger-App
+	 * 	is mid-write the snapshot is discarded, #tornReads is incremented, and the new
+	 * 	configuration is picked up on a later tick.
+	 * @param[in,out] config The Pick-Robot's copy of the configuration.
+	 * @return Whether a new, consistent #JSON_CONFIG was copied.
 	 */
-	bool readRobotIn(ROBOT_IN*);
+	bool readConfig(JSON_CONFIG *config);
 
 	/**
 	 * @fn writeRobotOut
-	 * @brief Write current Pick-Robot status information to the Pick-Trigger-App
+	 * @brief Write current Pick-Robot status information to the Pick-Trigger-App. Wakes the
+	 * 	Pick-Trigger-App (without blocking) if anything but the counters changed since it was last woken.
 	 * @param[in] ROBOT_OUT Reference to #ROBOT_OUT structure.
 	 */
 	bool writeRobotOut(ROBOT_OUT*);
+
+	/**
+	 * @fn appendTelemetry
+	 * @brief Append a compact #TELEMETRY_RECORD of this tick's status to the
+	 * 	#TELEMETRY_HISTORY, so readers see every tick regardless of their polling rate.
+	 * @param[in] status This tick's #ROBOT_OUT.
+	 */
+	void appendTelemetry(ROBOT_OUT *status);
+
+	/**
+	 * @fn pendingCommands
+	 * @return The number of commands currently queued by the Pick-Trigger-App.
+	 */
+	unsigned int pendingCommands();
+
+	/**
+	 * @fn waitForCommand
+	 * @brief Sleep until the Pick-Trigger-App queues a command past those counted by
+	 * 	the last #pendingCommands, or until @p deadline.
+	 * @param[in] deadline Absolute CLOCK_MONOTONIC time of the next tick.
+	 * @return 0 if a command may be waiting, ETIMEDOUT once the deadline has passed,
+	 * 	otherwise the error of the wait, see #sharedEventWait.
+	 */
+	int waitForCommand(const struct timespec *deadline);
+
+	/**
+	 * @fn popCommand
+	 * @brief Take the oldest command queued by the Pick-Trigger-App, without blocking.
+	 * @param[out] command The popped command.
+	 * @return Whether a command was available.
+	 */
+	bool popCommand(COMMAND_STRUCT *command);
+
+	/**
+	 * @fn getTornReads
+	 * @return The number of #JSON_CONFIG snapshots discarded as torn.
+	 */
+	long getTornReads() {
+		return tornReads;
+	}
+
+	/**
+	 * @fn reportStatus
+	 * @brief Report torn reads and command ring accounting to #ROBOT_OUT.
+	 * @param[out] ipcStatus The #IPC_STATUS of #ROBOT_OUT.
+	 */
+	void reportStatus(IPC_STATUS *ipcStatus);
 };
 
 
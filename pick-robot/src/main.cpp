@@ -2,13 +2,20 @@
 
 #include <ConfigStruct.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <json.hpp>
+#include <l6470constants.h>
+#include <LoopStats.h>
+#include <malloc.h>
 #include <sched.h>
 #include <slushboard.h>
+#include <sys/mman.h>
 #include <sys/time.h>
 #include <SharedMemoryStructs.h>
 #include <unistd.h>
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -24,13 +31,26 @@
 #include "Hardware/Motors/MotorFactory.h"
 #include "Hardware/Motors/MotorInterface.h"
 #include "Hardware/PinInteractions/I2C.h"
+#ifdef LOCAL
+#include "Hardware/PinInteractions/HostMotorBus.h"
+#endif
+#include "Hardware/PinInteractions/IoWorker.h"
 #include "Software/CommandHandler/CommandHandler.h"
 #include "Software/ErrorHandler/ErrorHandler.h"
 #include "Software/MotorController/MotorController.h"
 #include "Software/PickControl/PickControl.h"
+#include "Software/TargetGeneration/HighestPickOrder.h"
+#include "Software/TargetGeneration/NearestPickOrder.h"
 #include "Software/TargetGeneration/TargetGenerator.h"
 #include "Software/ZeroReturn/ZeroReturnController.h"
+#include "Utilities/AllocationGuard.h"
 #include "Utilities/Axis.h"
+#include "Utilities/ComponentPipeline.h"
+#include "Utilities/ComponentProfiler.h"
+#include "Utilities/ComponentRegistry.h"
+#include "Utilities/ComponentScheduler.h"
+#include "Utilities/MotionProfile.h"
+#include "Utilities/PositionSnapshot.h"
 #include "Utilities/SharedMemory.h"
 
 // for convenience
@@ -40,7 +60,11 @@ using json = nlohmann::json;
 #define NSEC_PER_SEC		1000000000L
 #define NANO_INC            1000000L
 
-static std::vector<ComponentInterface*> components;
+#define RT_STACK_PREFAULT_SIZE	(512 * 1024)		// Stack touched before entering the real-time loop
+#define RT_HEAP_PREFAULT_SIZE	(8 * 1024 * 1024)	// Heap reserved before entering the real-time loop
+#define SCHEDULE_TICK_BUDGET_US	800					// Component time per tick, the rest covers wakeup latency and IPC
+#define SESSION_STALL_TICKS		600000				// Simulated ticks without a pick before a session is abandoned
+
 static inline void tsnorm(struct timespec *ts) {
 	while (ts->tv_nsec >= NSEC_PER_SEC) {
 		ts->tv_nsec -= NSEC_PER_SEC;
@@ -48,6 +72,10 @@ static inline void tsnorm(struct timespec *ts) {
 	}
 }
 
+static inline long long tsToNs(const struct timespec *ts) {
+	return (long long) ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
 static bool prioritySet = false;
 static ROBOT_OUT status;
 static SharedMemory* sharedMemory;
@@ -55,11 +83,18 @@ static SlushBoard * slushboard;
 static PickControl *pickControl;
 static MotorController *motorController;
 static ZeroReturnController * zc;
+static PositionSnapshot *positionSnapshot;
 static Gripper *vc;
-static ROBOT_IN robotIn;
+static JSON_CONFIG robotConfig;
+static COMMAND_STRUCT command;
 static TargetGenerator* tg;
 static CommandHandler* commandHandler;
 static I2C *i2c;
+static ComponentProfiler *profiler;
+static ComponentScheduler *scheduler;
+static ComponentRegistry *registry;
+static TickPipeline *pipeline;
+static bool simulatedSession = false;
 
 // For Testing
 void writeToFile(std::string filename, std::string values);
@@ -67,7 +102,24 @@ void collectSuctionData();
 void testTargetGenerator();
 
 int main(int argc, char **argv) {
+	if (argc > 1 && strcmp(argv[1], "--benchmark-ipc") == 0) {
+		benchmarkIpc();
+	}
+#ifdef LOCAL
+	if (argc > 1 && strcmp(argv[1], "--validate-bus") == 0) {
+		validateMotorBus();
+	}
+#endif
+	if (argc > 1 && strcmp(argv[1], "--simulate-session") == 0) {
+		simulatedSession = true;
+	}
 	jsonInitialization();
+	if (argc > 1 && strcmp(argv[1], "--benchmark-pipeline") == 0) {
+		benchmarkPipeline();
+	}
+	if (argc > 2 && strcmp(argv[1], "--validate-motion") == 0) {
+		validateMotionModel(argv[2]);
+	}
 	realTimeLoop();
 	return 0;
 }
@@ -75,24 +127,24 @@ int main(int argc, char **argv) {
 void jsonInitialization() {
 	status = {0};
 	sharedMemory = new SharedMemory();
+	profiler = new ComponentProfiler();
+	scheduler = new ComponentScheduler(profiler);
+	registry = new ComponentRegistry(scheduler);
 	slushboard = new SlushBoard();
 
 	printf("Waiting for config over shared memory\n");
-	while (true) {
-		if (!sharedMemory->readRobotIn(&robotIn) && robotIn.config.hash != 0) {
-			printf("Configuration received.\n");
-			break;
-		}
+	while (!sharedMemory->readConfig(&robotConfig)) {
 		usleep(500);
 	}
+	printf("Configuration received.\n");
 
-	if (robotIn.config.runtimeFlags.simulate) {
+	if (robotConfig.runtimeFlags.simulate) {
 		std::cout << "SIMULATE MODE" << std::endl;
 	}
 	else {
 		std::cout << "LIVE MODE" << std::endl;
 	}
-	if (robotIn.config.runtimeFlags.realtime) {
+	if (robotConfig.runtimeFlags.realtime) {
 		std::cout << "REALTIME MODE" << std::endl;
 	}
 	else {
@@ -101,7 +153,7 @@ void jsonInitialization() {
 
 
 	std::array<Axis *, NUM_AXES> axes;
-	AXIS_CONFIG *axisConfig = robotIn.config.axes;
+	AXIS_CONFIG *axisConfig = robotConfig.axes;
 	for(int i = 0; i < NUM_AXES; i++) {
 		if(axisConfig[i].valid) {
 			std::vector<MotorInterface *> motors;
@@ -109,8 +161,7 @@ void jsonInitialization() {
 			for(int j = 0; j < MAX_MOTORS_PER_AXIS; j++) {
 				MOTOR_CONFIG motor = motorConfig[j];
 				if(motor.valid) {
-					motors.push_back(MotorFactory::create(robotIn.config.runtimeFlags.simulate, &motor));
-					components.push_back(MotorFactory::create(robotIn.config.runtimeFlags.simulate, &motor));
+					motors.push_back(registry->getMotor(robotConfig.runtimeFlags.simulate, &motor));
 				}
 			}
 			switch(axisConfig[i].axisLabel)
@@ -128,24 +179,39 @@ void jsonInitialization() {
 		}
 	}
 	i2c = new I2C(CONFIG::ADS1x15_DEFAULT_ADDRESS);
-	vc = GripperFactory::create(robotIn.config.runtimeFlags.simulate, slushboard);
+	vc = GripperFactory::create(robotConfig.runtimeFlags.simulate, slushboard);
 
-	status.runtimeFlags.realtime = robotIn.config.runtimeFlags.realtime;
-	status.runtimeFlags.simulate = robotIn.config.runtimeFlags.simulate;
-	status.runtimeFlags.logAxesData = robotIn.config.runtimeFlags.logAxesData;
-	status.runtimeFlags.ignoreErrorFlags = robotIn.config.runtimeFlags.ignoreErrorFlags;
+	status.runtimeFlags.realtime = robotConfig.runtimeFlags.realtime;
+	status.runtimeFlags.simulate = robotConfig.runtimeFlags.simulate;
+	status.runtimeFlags.logAxesData = robotConfig.runtimeFlags.logAxesData;
+	status.runtimeFlags.ignoreErrorFlags = robotConfig.runtimeFlags.ignoreErrorFlags;
+	status.runtimeFlags.simSpeedup = robotConfig.runtimeFlags.simSpeedup;
+	status.runtimeFlags.blendMotion = robotConfig.runtimeFlags.blendMotion;
 
 	motorController = new MotorController(axes);
 	zc = new ZeroReturnController(motorController);
+	uint32_t geometry = PositionSnapshot::getGeometry(robotConfig.axes);
+	zc->setGeometry(geometry);
+	if (!robotConfig.runtimeFlags.simulate) {
+		// Simulated positions mean nothing to the drivers
+		positionSnapshot = new PositionSnapshot();
+		if (zc->restore(positionSnapshot, geometry)) {
+			std::cout << "Motors held their homed positions, zero return skipped" << std::endl;
+		}
+	}
 
-	tg = new TargetGenerator( &robotIn.config.targetGeneratorConfig);
+	tg = new TargetGenerator( &robotConfig.targetGeneratorConfig);
+	tg->setPickOrder(PO_NEAREST, new NearestPickOrder(motorController));
+	tg->setPickOrder(PO_HIGHEST, new HighestPickOrder());
 	pickControl = new PickControl(sharedMemory, motorController, vc, zc, tg);
-	ErrorHandler::getInstance()->shouldIgnoreErrors(robotIn.config.runtimeFlags.ignoreErrorFlags);
-	components.push_back(ErrorHandler::getInstance());
-	components.push_back(pickControl);
-	components.push_back(motorController);
-	components.push_back(vc);
-	components.push_back(zc);
+	pickControl->setBlendMotion(robotConfig.runtimeFlags.blendMotion);
+	ErrorHandler::getInstance()->shouldIgnoreErrors(robotConfig.runtimeFlags.ignoreErrorFlags);
+	registry->add(ErrorHandler::getInstance(), "ErrorHandler");
+	// The motor controller takes the tick's clock and error level before the pick control plans moves
+	registry->add(motorController, "MotorController");
+	registry->add(pickControl, "PickControl");
+	registry->add(vc, "Gripper");
+	registry->add(zc, "ZeroReturn");
 	commandHandler = new CommandHandler(sharedMemory, pickControl, zc, motorController, vc, tg);
 }
 
@@ -191,67 +257,329 @@ void setPriority() {
 #endif
 }
 
+#ifndef LOCAL
+static bool prefaultStack() {
+	unsigned char stack[RT_STACK_PREFAULT_SIZE];
+	memset(stack, 0, RT_STACK_PREFAULT_SIZE);
+	// Keep the compiler from dropping the otherwise unused writes
+	asm volatile ("" : : "r" (stack) : "memory");
+	return true;
+}
+
+static bool prefaultHeap() {
+	// Keep freed memory in the heap instead of returning it, or it faults in again
+	if (!mallopt(M_TRIM_THRESHOLD, -1) || !mallopt(M_MMAP_MAX, 0)) {
+		return false;
+	}
+	char *heap = (char *) malloc(RT_HEAP_PREFAULT_SIZE);
+	if (heap == NULL) {
+		return false;
+	}
+	long pageSize = sysconf(_SC_PAGE_SIZE);
+	for (long offset = 0; offset < RT_HEAP_PREFAULT_SIZE; offset += pageSize) {
+		heap[offset] = 0;
+	}
+	free(heap);
+	return true;
+}
+
+static bool pinToCpu(int cpu) {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+		return false;
+	}
+	CPU_ZERO(&set);
+	return sched_getaffinity(0, sizeof(cpu_set_t), &set) == 0 && CPU_COUNT(&set) == 1 && CPU_ISSET(cpu, &set);
+}
+
+static bool isCpuIsolated(int cpu) {
+	// Kernel cpulist format, e.g. "2-3" or "1,3"
+	std::ifstream isolated("/sys/devices/system/cpu/isolated");
+	int first, last;
+	while (isolated >> first) {
+		last = first;
+		if (isolated.peek() == '-') {
+			isolated.get();
+			isolated >> last;
+		}
+		if (cpu >= first && cpu <= last) {
+			return true;
+		}
+		if (isolated.peek() == ',') {
+			isolated.get();
+		}
+	}
+	return false;
+}
+#endif
+
+/**
+ * Lock and prefault memory, pin to the real time core and raise the priority.
+ * Reports every guarantee through #REALTIME_STATUS.
+ * @return Whether every guarantee (but core isolation) was obtained.
+ */
+bool hardenRealtime() {
+#ifndef LOCAL
+	REALTIME_STATUS *rt = &status.rtStatus;
+	rt->cpu = robotConfig.runtimeFlags.realtimeCpu;
+	if (rt->cpu < 0) {
+		rt->cpu = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+	}
+	rt->memoryLocked = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+	rt->stackPrefaulted = prefaultStack() && rt->memoryLocked;
+	rt->heapPrefaulted = prefaultHeap() && rt->memoryLocked;
+	rt->cpuPinned = pinToCpu(rt->cpu);
+	rt->cpuIsolated = isCpuIsolated(rt->cpu);
+	setPriority();
+	rt->priorityFifo = prioritySet;
+
+	printf("Memory locked: %s\n", rt->memoryLocked ? "OK" : "FAILED");
+	printf("Stack prefaulted: %s\n", rt->stackPrefaulted ? "OK" : "FAILED");
+	printf("Heap prefaulted: %s\n", rt->heapPrefaulted ? "OK" : "FAILED");
+	printf("Pinned to CPU %d: %s\n", rt->cpu, rt->cpuPinned ? "OK" : "FAILED");
+	printf("CPU %d isolated: %s\n", rt->cpu, rt->cpuIsolated ? "yes" : "no (add isolcpus to the kernel command line)");
+	return rt->memoryLocked && rt->stackPrefaulted && rt->heapPrefaulted && rt->cpuPinned && rt->priorityFifo;
+#else
+	printf("LOCAL build, real-time hardening skipped.\n");
+	return false;
+#endif
+}
+
+/**
+ * Build the statically dispatched pipeline for the motor and gripper types in use.
+ * Stage order must match the order components were added to the scheduler.
+ */
+template<typename Motor, typename VacuumGripperType>
+static TickPipeline *buildPipeline() {
+	typedef ComponentPipeline<
+			PipelineStage<Motor, IO_MAX_MOTORS>,
+			PipelineStage<ErrorHandler>,
+			PipelineStage<MotorController>,
+			PipelineStage<PickControl>,
+			PipelineStage<VacuumGripperType>,
+			PipelineStage<ZeroReturnController> > Pipeline;
+	Pipeline *typed = new Pipeline(scheduler, profiler);
+	for (unsigned int index = 0; index < registry->getNumberOfMotors(); index++) {
+		typed->add(static_cast<Motor *>(registry->getMotorAt(index)));
+	}
+	typed->add(ErrorHandler::getInstance());
+	typed->add(motorController);
+	typed->add(pickControl);
+	typed->add(static_cast<VacuumGripperType *>(vc));
+	typed->add(zc);
+	return typed;
+}
+
+/**
+ * Pick the pipeline for this run, after the scheduler is planned.
+ * @return The pipeline, or NULL to dispatch through the scheduler.
+ */
+static TickPipeline *createPipeline() {
+	TickPipeline *created = robotConfig.runtimeFlags.simulate ?
+			buildPipeline<SimMotor, SimVacGripper>() : buildPipeline<StepperMotor, VacuumGripper>();
+	if (!created->isComplete()) {
+		printf("Component pipeline is missing components, dispatching through the scheduler.\n");
+		delete created;
+		return NULL;
+	}
+	return created;
+}
+
+/**
+ * Nanoseconds between ticks. Simulated motion only depends on the tick count, so
+ * without realtime the simulation can run on a virtual clock faster than the wall clock.
+ * @return #NANO_INC, #NANO_INC divided by the speedup, or 0 to run unthrottled.
+ */
+static long tickPeriodNs() {
+	if (!robotConfig.runtimeFlags.simulate || robotConfig.runtimeFlags.realtime) {
+		return NANO_INC;
+	}
+	float speedup = robotConfig.runtimeFlags.simSpeedup;
+	if (speedup <= 0) {
+		printf("Simulating as fast as possible.\n");
+		return 0;
+	}
+	printf("Simulating at %gx real time.\n", speedup);
+	return std::max(1L, (long) (NANO_INC / speedup));
+}
+
+/**
+ * Queue the commands the Pick-Trigger-App would, picking until the box is empty.
+ * @return Whether the session is still running.
+ */
+static bool driveSimulatedSession(long long int clockTicks) {
+	static long long int lastPickTick = 0;
+	static long int itemsPicked = 0;
+	COMMAND_STRUCT sessionCommand = { COMMAND_IDLE };
+	switch (pickControl->getState()) {
+		case PC_NEEDS_ZERO:
+			sessionCommand.command = COMMAND_ZERO_RETURN;
+			break;
+		case PC_READY:
+			if (tg->isNeedNewBox()) {
+				return false;
+			}
+			sessionCommand.command = COMMAND_PICK_ITEM;
+			break;
+		case PC_AT_DROPOFF_XYZ:
+			sessionCommand.command = COMMAND_DROP_ITEM;
+			break;
+		default:
+			break;
+	}
+	if (sessionCommand.command != COMMAND_IDLE) {
+		commandHandler->processCommand(&sessionCommand, &robotConfig);
+	}
+	if (status.pc_status.itemsPicked != itemsPicked) {
+		itemsPicked = status.pc_status.itemsPicked;
+		lastPickTick = clockTicks;
+	}
+	if (clockTicks - lastPickTick > SESSION_STALL_TICKS) {
+		printf("Session stalled in pick state %d.\n", pickControl->getState());
+		return false;
+	}
+	return true;
+}
+
 /**
  * Run the real time loop and monitor for deadline violations
  */
 void realTimeLoop() {
-	setPriority();
+	status.rtStatus.scheduleBudgetUs = SCHEDULE_TICK_BUDGET_US;
+	bool scheduled = scheduler->plan(SCHEDULE_TICK_BUDGET_US);
+	status.rtStatus.scheduleWorstTickUs = scheduler->getWorstTickUs();
+	pipeline = createPipeline();
+	if (!scheduled && robotConfig.runtimeFlags.realtime) {
+		printf("Component schedule exceeds the tick budget, refusing to enter the real-time loop.\n");
+		reportStatus();
+		exit(1);
+	}
+#ifndef LOCAL
+	if (!hardenRealtime() && robotConfig.runtimeFlags.realtime) {
+		printf("Real-time guarantees not met, refusing to enter the real-time loop.\n");
+		reportStatus();
+		exit(1);
+	}
+#else
+	hardenRealtime();
+#endif
+	// The worker allocates its bus on creation, so create it before the guarded loop even when simulating
+	IoWorker::getInstance();
+	// From here on only the worker touches the SPI and I2C buses
+	if (!robotConfig.runtimeFlags.simulate) {
+		printf("Bus transactions during setup: %u\n", IoWorker::getInstance()->getReadings()->transactions);
+		IoWorker::getInstance()->start(status.rtStatus.cpu);
+	}
+	if (simulatedSession && !robotConfig.runtimeFlags.simulate) {
+		printf("Simulated sessions need simulate, running live.\n");
+		simulatedSession = false;
+	}
+	long tickNs = tickPeriodNs();
+	allocationGuardInit();
+	unsigned long allocations = 0;
 	static long long int clockTicks;
 	struct timespec timespec;
 	clock_gettime(CLOCK_MONOTONIC, &timespec);
-	timespec.tv_nsec += NANO_INC;
+	struct timespec started = timespec;
+	timespec.tv_nsec += tickNs;
 	tsnorm(&timespec);
 	struct timespec after;
+	struct timespec done;
 	long int secs = timespec.tv_sec;
 	bool deadlineViolation = false;
+	long long wokeNs;
+#ifndef LOCAL
+	long wakeupLatency;
+#endif
 
 	while (true) {
 #ifndef LOCAL
-		static int clockReturn = 0;
-		clockReturn = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &timespec, NULL);
-		if (clockReturn != 0) {
-			//if (clockReturn != EINTR)
-				printf("clock_nanosleep failed. errno: %d clockReturn: %d\n",
-						errno, clockReturn);
+		// Sleep until the next tick, acting on commands as soon as they are queued
+		int waitReturn;
+		while ((waitReturn = sharedMemory->waitForCommand(&timespec)) != ETIMEDOUT) {
+			if (waitReturn == 0) {
+				allocationGuardArm();
+				processCommands();
+				allocationGuardDisarm();
+			} else if (waitReturn != EINTR) {
+				break;
+			}
+		}
+		if (waitReturn != ETIMEDOUT) {
+			printf("Waiting for the next tick failed. errno: %d\n", waitReturn);
 			break;
 		}
 		clock_gettime(CLOCK_MONOTONIC, &after);
+		wokeNs = tsToNs(&after);
+		wakeupLatency = wokeNs - tsToNs(&timespec);
 		if (after.tv_sec > timespec.tv_sec) {
 			after.tv_nsec += NSEC_PER_SEC * (after.tv_sec - timespec.tv_sec);
 		}
 		//Only enforce deadlines if we're running in real time mode (priority set)
-		if (!deadlineViolation && prioritySet && timespec.tv_nsec + NANO_INC < after.tv_nsec) {
+		if (!deadlineViolation && prioritySet && tickNs == NANO_INC && timespec.tv_nsec + NANO_INC < after.tv_nsec) {
 			printf("Deadline violation: %f ms.\n", ((double) after.tv_nsec - timespec.tv_nsec) / NSEC_PER_SEC * 1000);
 			printf("after.tv_sec: %ld\ntimespec.tv_sec: %ld\n", after.tv_sec, timespec.tv_sec);
 			printf("after.tv_nsec: %ld\ntimespec.tv_nsec: %ld\n", after.tv_nsec, timespec.tv_nsec);
-			if (robotIn.config.runtimeFlags.realtime) {
+			if (robotConfig.runtimeFlags.realtime) {
 				break;
 			}
 			deadlineViolation = true;
 		}
 #else
-		usleep(1000);
+		if (tickNs > 0) {
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &timespec, NULL);
+		}
+		clock_gettime(CLOCK_MONOTONIC, &after);
+		wokeNs = tsToNs(&after);
 #endif
-		timespec.tv_nsec += NANO_INC;
-		tsnorm(&timespec);
+		if (tickNs > 0) {
+			timespec.tv_nsec += tickNs;
+			tsnorm(&timespec);
+		} else {
+			// Unthrottled, the next tick is due as soon as this one is done
+			clock_gettime(CLOCK_MONOTONIC, &timespec);
+		}
 		clockTicks++;
 
-		if (sharedMemory->readRobotIn(&robotIn)) {
-			if (robotIn.commandStruct.command == COMMAND_EMERGENCY_STOP) {
-				for (unsigned int index = 0; index < components.size(); index++) {
-					components.at(index)->emergencyStop();
-				}
-			} else {
-				commandHandler->processCommand(&robotIn);
-			}
-		}
+		allocationGuardArm();
+		processCommands();
 
 		//Do real time stuff
 		tick(clockTicks);
 
-//		if (clockTicks % 50 == 0) {
-			reportStatus();
-//		}
+		reportStatus();
+		allocationGuardDisarm();
+		allocations = allocationGuardReport();
+
+		// Published with the next tick's status
+		clock_gettime(CLOCK_MONOTONIC, &done);
+		long execution = tsToNs(&done) - wokeNs;
+		loopHistogramRecord(&status.loopStats.execution, execution);
+#ifndef LOCAL
+		loopHistogramRecord(&status.loopStats.wakeupLatency, wakeupLatency);
+		if (tickNs > 0 && wakeupLatency + execution > tickNs) {
+			status.loopStats.overruns++;
+		}
+#endif
+		status.loopStats.ticks++;
+
+		if (simulatedSession && !driveSimulatedSession(clockTicks)) {
+			break;
+		}
+	}
+	if (simulatedSession) {
+		clock_gettime(CLOCK_MONOTONIC, &done);
+		double simulatedSeconds = clockTicks / 1000.0;
+		double realSeconds = (tsToNs(&done) - tsToNs(&started)) / (double) NSEC_PER_SEC;
+		printf("Session: %ld items in %.1f simulated s, %.2f real s (%.0fx real time), %.1f picks/hour simulated\n",
+				status.pc_status.itemsPicked, simulatedSeconds, realSeconds, simulatedSeconds / realSeconds,
+				status.pc_status.itemsPicked * 3600.0 / simulatedSeconds);
+		if (allocations > 0) {
+			printf("%lu allocations in the real-time loop.\n", allocations);
+		}
+		exit(status.pc_status.itemsPicked > 0 && tg->isNeedNewBox() && allocations == 0 ? 0 : 1);
 	}
 #ifndef LOCAL
 	clock_gettime(CLOCK_MONOTONIC, &timespec);
@@ -259,20 +587,53 @@ void realTimeLoop() {
 #endif
 }
 
+void processCommands() {
+	/*
+	 * Commands are counted before the config is read: the Pick-Trigger-App publishes
+	 * a new config before queuing COMMAND_LOAD_CONFIG, so every counted command sees it.
+	 * If the config was mid-write, leave the queue for the next tick.
+	 */
+	unsigned int pendingCommands = sharedMemory->pendingCommands();
+	long tornReads = sharedMemory->getTornReads();
+	sharedMemory->readConfig(&robotConfig);
+	if (tornReads != sharedMemory->getTornReads()) {
+		pendingCommands = 0;
+	}
+	for (; pendingCommands > 0 && sharedMemory->popCommand(&command); pendingCommands--) {
+		if (command.command == COMMAND_EMERGENCY_STOP) {
+			scheduler->emergencyStop();
+		} else {
+			commandHandler->processCommand(&command, &robotConfig);
+		}
+	}
+}
+
 void tick(long long int systime) {
-	static unsigned int index = 0;
-	for (index = 0; index < components.size(); index++) {
-		components.at(index)->step(systime);
+	static unsigned int lastTransactions = IoWorker::getInstance()->getReadings()->transactions;
+	IoWorker::getInstance()->sample();
+	unsigned int transactions = IoWorker::getInstance()->getReadings()->transactions;
+	status.loopStats.busTransactions += transactions - lastTransactions;
+	status.loopStats.busTransactionsMax = std::max(status.loopStats.busTransactionsMax, transactions - lastTransactions);
+	lastTransactions = transactions;
+	status.loopStats.ioRequestsDropped = IoWorker::getInstance()->getDropped();
+	if (pipeline) {
+		pipeline->step(systime);
+	} else {
+		scheduler->step(systime);
 	}
 }
 
 void reportStatus() {
-	static unsigned int index = 0;
-	for (index = 0; index < components.size(); index++) {
-		components.at(index)->reportStatus(&status);
+	if (pipeline) {
+		pipeline->reportStatus(&status);
+	} else {
+		scheduler->reportStatus(&status);
 	}
+	profiler->endTick(&status.profiles);
+	sharedMemory->reportStatus(&status.ipcStatus);
 	status.block_number++;
 	sharedMemory->writeRobotOut(&status);
+	sharedMemory->appendTelemetry(&status);
 }
 
 //Test functions
@@ -286,6 +647,7 @@ void testTargetGenerator() {
 	memcpy(config.boxStart, boxStart, sizeof(int) * 3);
 	memcpy(config.delta, delta, sizeof(int) * 3);
 	memcpy(config.dropLocation, boxDrop, sizeof(int) * 3);
+	config.pickOrder = PO_RASTER;
 	TargetGenerator * tg = new TargetGenerator(&config);
 	printf("Top of box: %d\n", tg->getTopOfBoxZ());
 	printf("Z Clearance Plane: %d\n", tg->getZClearancePlane());
@@ -302,6 +664,249 @@ void testTargetGenerator() {
 	exit(0);
 }
 
+/** The former ROBOT_IN: the whole configuration, tagged with a block number */
+typedef struct {
+	JSON_CONFIG config;
+	long block_number;
+} LEGACY_ROBOT_IN;
+
+/** The former start of the `robot_in` page, before the command ring moved in */
+typedef struct {
+	SEQLOCK lock;
+	LEGACY_ROBOT_IN block;
+} LEGACY_ROBOT_IN_SEGMENT;
+
+/**
+ * The former SharedMemory::readRobotIn, unchanged but for where the segment and torn read count live.
+ */
+static bool legacyReadRobotIn(LEGACY_ROBOT_IN_SEGMENT *segment, LEGACY_ROBOT_IN *block, long *tornReads) {
+	LEGACY_ROBOT_IN temp;
+	if (!seqlockTryRead(&segment->lock, &temp, &segment->block, sizeof(LEGACY_ROBOT_IN))) {
+		// Never wait on the Pick-Trigger-App, try again next tick
+		(*tornReads)++;
+		return false;
+	}
+	if (temp.block_number != block->block_number) {
+		memcpy(block, &temp, sizeof(LEGACY_ROBOT_IN));
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Measure the per-tick cost of picking up commands and configuration from the
+ * Pick-Trigger-App, as processCommands does with nothing queued. "Before" runs the former
+ * ROBOT_IN read on a shared segment laid out as it was, "after" the current config hash check.
+ * Uses its own `robot_bench` segments, so a running Pick-Trigger-App is left alone.
+ */
+void benchmarkIpc() {
+	const int iterations = 1000000;
+	struct timespec start, end;
+	sharedMemory = new SharedMemory("robot_bench");
+	int legacyMd = shm_open("robot_bench_legacy", O_CREAT | O_RDWR, 0666);
+	if (legacyMd < 0 || ftruncate(legacyMd, sizeof(LEGACY_ROBOT_IN_SEGMENT)) == -1) {
+		perror("robot_bench_legacy");
+		exit(1);
+	}
+	LEGACY_ROBOT_IN_SEGMENT *legacySegment = (LEGACY_ROBOT_IN_SEGMENT *) mmap(0, sizeof(LEGACY_ROBOT_IN_SEGMENT),
+			PROT_WRITE | PROT_READ, MAP_SHARED, legacyMd, 0);
+	memset(legacySegment, 0, sizeof(LEGACY_ROBOT_IN_SEGMENT));
+	mlock(legacySegment, sizeof(LEGACY_ROBOT_IN_SEGMENT));
+	static LEGACY_ROBOT_IN legacyRobotIn;
+	long legacyTornReads = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < iterations; i++) {
+		unsigned int pendingCommands = sharedMemory->pendingCommands();
+		legacyReadRobotIn(legacySegment, &legacyRobotIn, &legacyTornReads);
+		if (pendingCommands > 0) {
+			sharedMemory->popCommand(&command);
+		}
+		asm volatile ("" ::: "memory");
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double before = ((end.tv_sec - start.tv_sec) * NSEC_PER_SEC + end.tv_nsec - start.tv_nsec) / (double) iterations;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < iterations; i++) {
+		unsigned int pendingCommands = sharedMemory->pendingCommands();
+		sharedMemory->readConfig(&robotConfig);
+		if (pendingCommands > 0) {
+			sharedMemory->popCommand(&command);
+		}
+		asm volatile ("" ::: "memory");
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double after = ((end.tv_sec - start.tv_sec) * NSEC_PER_SEC + end.tv_nsec - start.tv_nsec) / (double) iterations;
+
+	printf("Per-tick IPC before (ROBOT_IN, %u bytes copied): %.1f ns\n", (unsigned int) sizeof(LEGACY_ROBOT_IN), before);
+	printf("Per-tick IPC after (command ring + config hash): %.1f ns\n", after);
+	munmap(legacySegment, sizeof(LEGACY_ROBOT_IN_SEGMENT));
+	close(legacyMd);
+	shm_unlink("robot_bench_legacy");
+	delete sharedMemory;
+	exit(0);
+}
+
+/**
+ * Measure the per-tick cost of stepping and reporting every component, through the
+ * scheduler's virtual dispatch and through the statically dispatched pipeline.
+ * Run with the Pick-Trigger-App providing the configuration; nothing is commanded.
+ */
+void benchmarkPipeline() {
+	const int iterations = 200000;
+	struct timespec start, end;
+	scheduler->plan(SCHEDULE_TICK_BUDGET_US);
+	pipeline = createPipeline();
+	if (pipeline == NULL) {
+		exit(1);
+	}
+	long long int clockTicks = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < iterations; i++) {
+		clockTicks++;
+		scheduler->step(clockTicks);
+		scheduler->reportStatus(&status);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double before = ((end.tv_sec - start.tv_sec) * NSEC_PER_SEC + end.tv_nsec - start.tv_nsec) / (double) iterations;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < iterations; i++) {
+		clockTicks++;
+		pipeline->step(clockTicks);
+		pipeline->reportStatus(&status);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double after = ((end.tv_sec - start.tv_sec) * NSEC_PER_SEC + end.tv_nsec - start.tv_nsec) / (double) iterations;
+
+	printf("Per-tick components, virtual dispatch (%u components): %.1f ns\n", scheduler->getNumberOfComponents(), before);
+	printf("Per-tick components, static pipeline: %.1f ns\n", after);
+	exit(0);
+}
+
+/**
+ * Print one move of a recorded position log next to its modelled duration.
+ * @return The modelled duration without acceleration minus the recorded one, in milliseconds.
+ */
+static double validateMove(const char *state, long long int ticks, const int *from, const int *to) {
+	double constantMs = 0;
+	double trapezoidMs = 0;
+	for (int i = 0; i < NUM_AXES; i++) {
+		axis_pos distance = std::abs(to[i] - from[i]);
+		constantMs = std::max(constantMs, MotionProfile::getTravelTime(distance,
+				motorController->getMaxSpeedMMPerSec((AXIS) i), 0, 0) * SEC_TO_MILL);
+		trapezoidMs = std::max(trapezoidMs, motorController->getTravelTime((AXIS) i, distance) * SEC_TO_MILL);
+	}
+	printf("  %-32s %5d %5d %5d %8lld %8.0f %8.0f\n", state, to[X] - from[X], to[Y] - from[Y], to[Z] - from[Z],
+			ticks, constantMs, trapezoidMs);
+	return constantMs - ticks;
+}
+
+/**
+ * Compare the motion model against a recorded position log, such as Data/positionData.txt.
+ * Every pick state that moved an axis is a move: the recorded clock ticks until the next
+ * state against the modelled duration, once without acceleration (how the log was
+ * simulated) and once with the configured acceleration and deceleration.
+ * Run with the Pick-Trigger-App providing the configuration the log was recorded with.
+ */
+void validateMotionModel(const char *path) {
+	FILE *log = fopen(path, "r");
+	if (log == NULL) {
+		printf("Can't open %s\n", path);
+		exit(1);
+	}
+	char line[256];
+	char state[64] = "";
+	long long int stateTick = -1;
+	int position[NUM_AXES] = {0, 0, 0};
+	int from[NUM_AXES] = {0, 0, 0};
+	int moves = 0;
+	double totalError = 0;
+	double worstError = 0;
+
+	printf("  %-32s %5s %5s %5s %8s %8s %8s\n", "state", "dX", "dY", "dZ", "log ms", "model", "accel");
+	while (fgets(line, sizeof(line), log) != NULL) {
+		long long int tick;
+		char nextState[64];
+		int x, y, z;
+		if (sscanf(line, "%lld Number of items picked: %*d Status state: %63s", &tick, nextState) == 2) {
+			bool moved = position[X] != from[X] || position[Y] != from[Y] || position[Z] != from[Z];
+			if (stateTick >= 0 && moved) {
+				double error = validateMove(state, tick - stateTick, from, position);
+				totalError += std::fabs(error);
+				worstError = std::max(worstError, std::fabs(error));
+				moves++;
+			}
+			stateTick = tick;
+			strcpy(state, nextState);
+			std::copy(position, position + NUM_AXES, from);
+		} else if (sscanf(line, "%d, %d, %d", &x, &y, &z) == 3) {
+			position[X] = x;
+			position[Y] = y;
+			position[Z] = z;
+		}
+	}
+	fclose(log);
+	if (moves > 0) {
+		printf("%d moves, model without acceleration off by %.1f ms on average, %.0f ms at worst\n", moves,
+				totalError / moves, worstError);
+	}
+	exit(moves > 0 ? 0 : 1);
+}
+
+#ifdef LOCAL
+/**
+ * Check the MAX_SPEED rounding the #IoWorker batches moves with against the stand-in bus:
+ * a speed below one MAX_SPEED unit still moves, while a driver left at MAX_SPEED 0 never
+ * completes its move. Needs no configuration.
+ */
+void validateMotorBus() {
+	int failures = 0;
+	const float speeds[] = {0, 10, 15.25, 1000, 20000};
+	const unsigned long expected[] = {1, 1, 1, 66, 0x3FF};
+	for (unsigned int i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++) {
+		unsigned long value = MotorBus::maxSpeedRegister(speeds[i]);
+		printf("  MAX_SPEED for %8.2f steps/s: %4lu, expected %4lu\n", speeds[i], value, expected[i]);
+		failures += value != expected[i];
+	}
+
+	// Slot 0 at the slowest speed the IoWorker sends, slot 1 at MAX_SPEED 0, one full step each
+	HostMotorBus host;
+	MotorBus &bus = host;
+	unsigned long maxSpeeds[MOTOR_BUS_MAX_DRIVERS] = {MotorBus::maxSpeedRegister(10), 0, 0, 0};
+	long positions[MOTOR_BUS_MAX_DRIVERS] = {128, 128, 0, 0};
+	unsigned long statuses[MOTOR_BUS_MAX_DRIVERS];
+	unsigned long absPos[MOTOR_BUS_MAX_DRIVERS];
+	bus.setParam(L6470_PARAM_MAX_SPEED, 0x3, maxSpeeds);
+	bus.goTo(0x3, positions);
+	for (int polls = 0; polls < 100; polls++) {
+		usleep(10000);
+		bus.getStatus(0x3, statuses);
+		if (statuses[0] & L6470_STATUS_BUSY) {
+			break;
+		}
+	}
+	bus.getStatus(0x3, statuses);
+	bus.getParam(L6470_PARAM_ABS_POS, 0x3, absPos);
+	bool slowDone = (statuses[0] & L6470_STATUS_BUSY) && MotorBus::toPosition(absPos[0]) == positions[0];
+	bool stalledBusy = !(statuses[1] & L6470_STATUS_BUSY) && MotorBus::toPosition(absPos[1]) == 0;
+	printf("  Move at MAX_SPEED %lu: %s at %ld\n", maxSpeeds[0], slowDone ? "completed" : "FAILED", MotorBus::toPosition(absPos[0]));
+	printf("  Move at MAX_SPEED 0: %s at %ld\n", stalledBusy ? "still busy" : "FAILED", MotorBus::toPosition(absPos[1]));
+	failures += !slowDone + !stalledBusy;
+
+	// A stop ends the stalled move where it is
+	bus.command(0x2, L6470_CMD_HARD_STOP);
+	bus.getStatus(0x2, statuses);
+	printf("  Hard stop at MAX_SPEED 0: %s\n", statuses[1] & L6470_STATUS_BUSY ? "completed" : "FAILED");
+	failures += !(statuses[1] & L6470_STATUS_BUSY);
+
+	printf("%d failures\n", failures);
+	exit(failures > 0 ? 1 : 0);
+}
+#endif
+
 void writeToFile(std::string filename, std::string values) {
 	ofstream fileObj;
 	fileObj.open(filename, std::ios::out | std::ios::app);
@@ -7,10 +7,18 @@ static inline void __dmb(void) {
 	asm volatile ("dmb" ::: "memory");
 }
 void jsonInitialization();
+bool hardenRealtime();
 void realTimeLoop();
+void processCommands();
 void tick(long long int);
 void reportStatus();
 
 //Test functions
 void testTargetGenerator();
+void benchmarkIpc();
+void benchmarkPipeline();
+void validateMotionModel(const char *path);
+#ifdef LOCAL
+void validateMotorBus();
+#endif
 #endif
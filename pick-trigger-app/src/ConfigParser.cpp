@@ -33,6 +33,15 @@ bool ConfigParser::loadJSONFromFile(std::string filePath, json* jsonPtr) {
 	return false;
 }
 
+int ConfigParser::limitHomingSpeed(int stepsPerSec, const char *name, char axisLabel) {
+	if (stepsPerSec > HOMING_MAX_STEPS_PER_SEC) {
+		printf("Config warning: %c %s %d is above the L6470 limit, using %d\n", axisLabel, name, stepsPerSec,
+				HOMING_MAX_STEPS_PER_SEC);
+		return HOMING_MAX_STEPS_PER_SEC;
+	}
+	return stepsPerSec;
+}
+
 bool ConfigParser::loadJSONFromString(std::string jsonData, json* jsonPtr) {
 	try {
 	*jsonPtr = json::parse(jsonData);
@@ -43,12 +52,11 @@ bool ConfigParser::loadJSONFromString(std::string jsonData, json* jsonPtr) {
 	return false;
 }
 
-void ConfigParser::parseConfig(ROBOT_IN *rin, json *dataPtr) {
+void ConfigParser::parseConfig(JSON_CONFIG *config, json *dataPtr) {
 	std::hash<nlohmann::json> hasher;
 
 	json data = *dataPtr;
 
-	JSON_CONFIG *config = &rin->config;
 	TARGET_GENERATOR_CONFIG *targetConfig;
 	AXIS_CONFIG *axisConfig;
 	MOTOR_CONFIG *motorConfig;
@@ -65,6 +73,7 @@ void ConfigParser::parseConfig(ROBOT_IN *rin, json *dataPtr) {
 	 * Simulate -> false
 	 * LogAxesData -> false
 	 * EmergencyStop -> false
+	 * RealtimeCpu -> -1 (last core)
 	 */
 	if (!data["runtimeFlags"]["realtime"].is_null()) {
 		config->runtimeFlags.realtime = data["runtimeFlags"]["realtime"].get<bool>();
@@ -82,8 +91,36 @@ void ConfigParser::parseConfig(ROBOT_IN *rin, json *dataPtr) {
 		config->runtimeFlags.ignoreErrorFlags = data["runtimeFlags"]["ignoreErrorFlags"].get<bool>();
 	}
 	config->runtimeFlags.emergencyStop = false;
+	if (!data["runtimeFlags"]["realtimeCpu"].is_null()) {
+		config->runtimeFlags.realtimeCpu = data["runtimeFlags"]["realtimeCpu"].get<int>();
+	}
+	else {
+		config->runtimeFlags.realtimeCpu = -1;
+	}
+	if (!data["runtimeFlags"]["simSpeedup"].is_null()) {
+		config->runtimeFlags.simSpeedup = data["runtimeFlags"]["simSpeedup"].get<float>();
+	}
+	else {
+		config->runtimeFlags.simSpeedup = 1;
+	}
+	if (!data["runtimeFlags"]["blendMotion"].is_null()) {
+		config->runtimeFlags.blendMotion = data["runtimeFlags"]["blendMotion"].get<bool>();
+	}
+	else {
+		config->runtimeFlags.blendMotion = false;
+	}
 
 	try {
+		// Raster unless "nearest" or "highest" is asked for
+		config->targetGeneratorConfig.pickOrder = PO_RASTER;
+		if (!data["targetGenerator"]["pickOrder"].is_null()) {
+			std::string pickOrder = data["targetGenerator"]["pickOrder"].get<std::string>();
+			if (pickOrder == "nearest") {
+				config->targetGeneratorConfig.pickOrder = PO_NEAREST;
+			} else if (pickOrder == "highest") {
+				config->targetGeneratorConfig.pickOrder = PO_HIGHEST;
+			}
+		}
 		for (int axisIndex = 0; axisIndex < numAxes; axisIndex++) {
 			targetConfig = &config->targetGeneratorConfig;
 			targetConfig->boxEnd[axisIndex] = data["targetGenerator"]["boxEnd"][axisIndex].get<int>();
@@ -98,6 +135,20 @@ void ConfigParser::parseConfig(ROBOT_IN *rin, json *dataPtr) {
 				axisConfig->axisLabel = data["axes"][axisIndex]["label"].get<std::string>().c_str()[0];
 				axisConfig->stagingArea = data["axes"][axisIndex]["stagingArea"].get<int>();
 				axisConfig->travelLimitmm = data["axes"][axisIndex]["travelLimitmm"].get<int>();
+				if (!data["axes"][axisIndex]["homingStepsPerSec"].is_null()) {
+					axisConfig->homingStepsPerSec = data["axes"][axisIndex]["homingStepsPerSec"].get<int>();
+				} else {
+					axisConfig->homingStepsPerSec = DEFAULT_HOMING_STEPS_PER_SEC;
+				}
+				if (!data["axes"][axisIndex]["homingCreepStepsPerSec"].is_null()) {
+					axisConfig->homingCreepStepsPerSec = data["axes"][axisIndex]["homingCreepStepsPerSec"].get<int>();
+				} else {
+					axisConfig->homingCreepStepsPerSec = DEFAULT_HOMING_CREEP_STEPS_PER_SEC;
+				}
+				axisConfig->homingStepsPerSec = limitHomingSpeed(axisConfig->homingStepsPerSec, "homingStepsPerSec",
+						axisConfig->axisLabel);
+				axisConfig->homingCreepStepsPerSec = limitHomingSpeed(axisConfig->homingCreepStepsPerSec,
+						"homingCreepStepsPerSec", axisConfig->axisLabel);
 				for (int motorIndex = 0; motorIndex < maxMotors; motorIndex++) {
 					motorConfig = &(axisConfig->motor[motorIndex]);
 					if (!data["axes"][axisIndex]["motors"][motorIndex].is_null()) {
@@ -120,6 +171,18 @@ void ConfigParser::parseConfig(ROBOT_IN *rin, json *dataPtr) {
 						motorConfig->maxStepsPerSec =
 								data["axes"][axisIndex]["motors"][motorIndex]["maxStepsPerSec"].get<
 								int>();
+						if (!data["axes"][axisIndex]["motors"][motorIndex]["accelStepsPerSec2"].is_null()) {
+							motorConfig->accelStepsPerSec2 =
+									data["axes"][axisIndex]["motors"][motorIndex]["accelStepsPerSec2"].get<int>();
+						} else {
+							motorConfig->accelStepsPerSec2 = DEFAULT_STEPS_PER_SEC2;
+						}
+						if (!data["axes"][axisIndex]["motors"][motorIndex]["decelStepsPerSec2"].is_null()) {
+							motorConfig->decelStepsPerSec2 =
+									data["axes"][axisIndex]["motors"][motorIndex]["decelStepsPerSec2"].get<int>();
+						} else {
+							motorConfig->decelStepsPerSec2 = DEFAULT_STEPS_PER_SEC2;
+						}
 						motorConfig->stepsPerRev =
 								data["axes"][axisIndex]["motors"][motorIndex]["stepsPerRev"].get<
 								int>();
@@ -27,11 +27,11 @@ public:
 	 * Handles the checking and assigning values passed from the configuration
 	 * 	to the Pick-Robot. If values are invalid or improperly formatted then
 	 * 	configuration is abandoned, otherwise the set config is assigned to
-	 * 	#ROBOT_IN, which feeds the data to the Pick-Robot.
-	 * @param[in] rin Reference to the %ROBOT_IN structure.
+	 * 	@p config, which is then published to the Pick-Robot.
+	 * @param[out] config Reference to the %JSON_CONFIG structure.
 	 * @param[in] data JSON file.
 	 */
-	void parseConfig(ROBOT_IN* rin, json *data);
+	void parseConfig(JSON_CONFIG* config, json *data);
 
 	/**
 	 * @loadJSONFromFile
@@ -48,6 +48,17 @@ public:
 	 * @param[out] json JSON object.
 	 */
 	bool loadJSONFromString(std::string jsonData, json *json);
+
+private:
+	/**
+	 * @fn limitHomingSpeed
+	 * @brief Warn about and clamp a homing speed the L6470 cannot run, see #HOMING_MAX_STEPS_PER_SEC.
+	 * @param[in] stepsPerSec The configured speed, in steps/second.
+	 * @param[in] name The configuration key, for the warning.
+	 * @param[in] axisLabel The axis, for the warning.
+	 * @return @p stepsPerSec, at most #HOMING_MAX_STEPS_PER_SEC.
+	 */
+	int limitHomingSpeed(int stepsPerSec, const char *name, char axisLabel);
 };
 
 #endif /* CONFIGPARSER_H_ */
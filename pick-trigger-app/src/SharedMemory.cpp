@@ -7,6 +7,9 @@
 
 #include "SharedMemory.h"
 #include "SharedMemory.h"
+
+#include <CommandRing.h>
+#include <TelemetryHistory.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/mman.h>
@@ -16,6 +19,9 @@
 #include <string.h>
 
 SharedMemory::SharedMemory() {
+	tornReads = 0;
+	historyLost = 0;
+	statusSequence = 0;
 	/* Create shared memory object */
 
 	robot_in_md = shm_open("robot_in", O_RDWR, 0666);
@@ -35,6 +41,23 @@ SharedMemory::SharedMemory() {
 		perror("mlock failure");
 		exit(1);
 	}
+
+	robot_config_md = shm_open("robot_config", O_RDWR, 0666);
+	/* Map the configuration */
+	robot_config_addr = mmap(0, sizeof(ROBOT_CONFIG_SEGMENT), PROT_WRITE | PROT_READ, MAP_SHARED, robot_config_md, 0);
+	if (robot_config_addr == MAP_FAILED) {
+		perror("robot_config mmap failure");
+		exit(1);
+	}
+
+	robot_history_md = shm_open("robot_history", O_RDONLY, 0666);
+	/* Map the whole history, read only */
+	robot_history_addr = mmap(0, sizeof(TELEMETRY_HISTORY), PROT_READ, MAP_SHARED, robot_history_md, 0);
+	if (robot_history_addr == MAP_FAILED) {
+		perror("robot_history mmap failure");
+		exit(1);
+	}
+	historyCursor = telemetryHistoryHead((TELEMETRY_HISTORY *) robot_history_addr);
 }
 
 SharedMemory::~SharedMemory() {
@@ -44,20 +67,55 @@ SharedMemory::~SharedMemory() {
 	munmap(robot_out_addr, pg_size); /* Unmap the page */
 	close(robot_out_md); /*   Close file   */
 	shm_unlink("robot_out"); /* Unlink shared-memory object */
+	munmap(robot_config_addr, sizeof(ROBOT_CONFIG_SEGMENT)); /* Unmap the configuration */
+	close(robot_config_md); /*   Close file   */
+	munmap(robot_history_addr, sizeof(TELEMETRY_HISTORY)); /* Unmap the history */
+	close(robot_history_md); /*   Close file   */
 }
 
-bool SharedMemory::writeRobotIn(ROBOT_IN *block) {
-	memcpy(robot_in_addr, block, sizeof(ROBOT_IN));
+bool SharedMemory::writeConfig(JSON_CONFIG *config) {
+	ROBOT_CONFIG_SEGMENT *segment = (ROBOT_CONFIG_SEGMENT *) robot_config_addr;
+	seqlockWrite(&segment->lock, &segment->config, config, sizeof(JSON_CONFIG));
+	__atomic_store_n(&segment->hash, config->hash, __ATOMIC_RELEASE);
 	return true;
 }
 
 bool SharedMemory::readRobotOut(ROBOT_OUT *status) {
+	ROBOT_OUT_SEGMENT *segment = (ROBOT_OUT_SEGMENT *) robot_out_addr;
 	ROBOT_OUT temp;
-	memcpy(&temp, robot_out_addr, sizeof(ROBOT_OUT));
-	if (temp.block_number != status->block_number) {
-		memcpy(status, &temp, sizeof(ROBOT_OUT));
-		return true;
+	// Sampled first: anything published after this point signals a later sequence
+	statusSequence = sharedEventSequence(&segment->statusEvent);
+	for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; attempt++) {
+		if (seqlockTryRead(&segment->lock, &temp, &segment->block, sizeof(ROBOT_OUT))) {
+			if (temp.block_number != status->block_number) {
+				memcpy(status, &temp, sizeof(ROBOT_OUT));
+				return true;
+			}
+			return false;
+		}
+		tornReads++;
 	}
 	return false;
 }
 
+bool SharedMemory::pushCommand(COMMAND_STRUCT *command) {
+	ROBOT_IN_SEGMENT *segment = (ROBOT_IN_SEGMENT *) robot_in_addr;
+	if (!commandRingPush(&segment->commands, command)) {
+		return false;
+	}
+	sharedEventSignal(&segment->commandEvent);
+	return true;
+}
+
+int SharedMemory::waitForStatus(const struct timespec *deadline) {
+	ROBOT_OUT_SEGMENT *segment = (ROBOT_OUT_SEGMENT *) robot_out_addr;
+	return sharedEventWait(&segment->statusEvent, statusSequence, deadline);
+}
+
+unsigned int SharedMemory::readTelemetry(TELEMETRY_RECORD *records, unsigned int max) {
+	unsigned int lost;
+	unsigned int count = telemetryHistoryRead((TELEMETRY_HISTORY *) robot_history_addr, &historyCursor,
+			records, max, &lost);
+	historyLost += lost;
+	return count;
+}
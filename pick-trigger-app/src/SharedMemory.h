@@ -19,6 +19,22 @@ private:
 	void* robot_in_addr;
 	/** Memory address of robot out */
 	void* robot_out_addr;
+	/** Number of read attempts on #ROBOT_OUT discarded because the Pick-Robot was mid-write */
+	long tornReads;
+	/** Memory descriptor for the configuration passed to the Pick-Robot */
+	int robot_config_md;
+	/** Memory address of the #ROBOT_CONFIG_SEGMENT */
+	void* robot_config_addr;
+	/** Memory descriptor for the #TELEMETRY_HISTORY written by the Pick-Robot */
+	int robot_history_md;
+	/** Memory address of the #TELEMETRY_HISTORY */
+	void* robot_history_addr;
+	/** Cursor of the next #TELEMETRY_RECORD to read */
+	unsigned int historyCursor;
+	/** Number of #TELEMETRY_RECORD overwritten before they could be read */
+	long historyLost;
+	/** The #ROBOT_OUT_SEGMENT::statusEvent sequence as of the last #readRobotOut */
+	unsigned int statusSequence;
 public:
 	/**
 	 * @brief Instance specific to the Pick-Trigger-App.
@@ -30,16 +46,71 @@ public:
 	 * @fn readRobotOut
 	 * @brief Read the passed information from the Pick-Robot. Used for reporting
 	 * 	status of the system.
+	 *
+	 * Retries up to #SEQLOCK_READ_ATTEMPTS times for a consistent snapshot, so
+	 * 	positions, pick state and errors always come from the same tick.
 	 * @param[in] status Current status of the system.
+	 * @return Whether a new, consistent #ROBOT_OUT was copied.
 	 */
 	bool readRobotOut(ROBOT_OUT*);
 
 	/**
-	 * @fn writeRobotIn
-	 * @brief Write input commands to the Pick-Robot.
-	 * @param[in] block Current commands or configurations.
+	 * @fn waitForStatus
+	 * @brief Sleep until the Pick-Robot publishes a status that changed since the last
+	 * 	#readRobotOut, or until @p deadline.
+	 * @param[in] deadline Absolute CLOCK_MONOTONIC time to give up at.
+	 * @return 0 if signalled, ETIMEDOUT if the deadline passed, otherwise the error
+	 * 	of the wait, see #sharedEventWait.
 	 */
-	bool writeRobotIn(ROBOT_IN*);
+	int waitForStatus(const struct timespec *deadline);
+
+	/**
+	 * @fn writeConfig
+	 * @brief Publish a configuration to the Pick-Robot, which copies it on its next
+	 * 	tick because its #JSON_CONFIG::hash changed. Queue #COMMAND_LOAD_CONFIG
+	 * 	afterwards to have it applied.
+	 * @param[in] config The parsed configuration.
+	 */
+	bool writeConfig(JSON_CONFIG *config);
+
+	/**
+	 * @fn pushCommand
+	 * @brief Queue a command for the Pick-Robot on the #COMMAND_RING, without blocking.
+	 *
+	 * Must only be called from a single thread (the ring has one producer). Wakes the
+	 * 	Pick-Robot if it is sleeping between ticks.
+	 * @param[in] command The command to queue.
+	 * @return Whether the command was queued, false if the ring was full.
+	 */
+	bool pushCommand(COMMAND_STRUCT *command);
+
+	/**
+	 * @fn readTelemetry
+	 * @brief Read the #TELEMETRY_RECORD appended by the Pick-Robot since the last call, oldest first.
+	 *
+	 * Records are kept for #TELEMETRY_HISTORY_SIZE ticks; if this reader falls further
+	 * 	behind the oldest records are skipped and counted by #getHistoryLost.
+	 * @param[out] records Destination for at most @p max records.
+	 * @param[in] max The capacity of @p records.
+	 * @return The number of records read.
+	 */
+	unsigned int readTelemetry(TELEMETRY_RECORD *records, unsigned int max);
+
+	/**
+	 * @fn getHistoryLost
+	 * @return The number of #TELEMETRY_RECORD skipped because this reader fell behind.
+	 */
+	long getHistoryLost() {
+		return historyLost;
+	}
+
+	/**
+	 * @fn getTornReads
+	 * @return The number of #ROBOT_OUT read attempts discarded as torn.
+	 */
+	long getTornReads() {
+		return tornReads;
+	}
 };
 
 #endif /* SRC_UTILITIES_SHAREDMEMORY_H_ */
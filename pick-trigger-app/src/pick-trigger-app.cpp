@@ -4,6 +4,7 @@
 #include <json.hpp>
 #include <netinet/in.h>
 #include <pthread.h>
+#include <sched.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <SharedMemoryStructs.h>
@@ -20,11 +21,13 @@
 #include <arpa/inet.h>
 #include "ConfigParser.h"
 #include "SharedMemory.h"
+#include <TelemetryHistory.h>
+#include <LoopStats.h>
 
 #define PORT 6000
 #define USEC_PER_SEC		1000000L
 #define NSEC_PER_SEC		1000000000L
-#define NANO_INC            1000000L
+#define STATUS_REFRESH_NSEC	100000000L	// Longest wait for the robot before refreshing the status anyway
 static inline void tsnorm(struct timespec *ts) {
 	while (ts->tv_nsec >= NSEC_PER_SEC) {
 		ts->tv_nsec -= NSEC_PER_SEC;
@@ -38,6 +41,10 @@ using json = nlohmann::json;
 
 
 json *robotStatusToJSON(json *jsonObj, ROBOT_OUT robotout);
+json *loopStatsToJSON(json *jsonObj, ROBOT_OUT robotout);
+json loopHistogramToJSON(const LOOP_HISTOGRAM *histogram);
+json *profilesToJSON(json *jsonObj, ROBOT_OUT robotout);
+json profileStatsToJSON(const PROFILE_STATS *stats);
 void displayErrors(ROBOT_OUT rout);
 void writeToFile(std::ostream &file, std::string values);
 std::string getSuctionString(SUCTION suck);
@@ -48,25 +55,30 @@ std::string getErrorLevelInfo(ERROR_LEVEL level);
 std::string getErrorInfo(ERROR_STATUS status);
 bool compareCommands(char * str1, const char *str2);
 void *connectionListener(void*);
-void parseStringForCommand(char *buffer, int length);
+bool parseStringForCommand(char *buffer, int length, COMMAND_STRUCT *command);
 bool nextInt(char** buffer);
 void sendDefaultConfig();
+void moveOffRealtimeCpu();
 void printCommandInformation();
-volatile bool sendCommand = false;
-volatile COMMAND command = COMMAND_PICK_ITEM;
-int target[3];
 int invalidTarget[] = { 1, 1, 1 };
 ConfigParser configParser;
 ROBOT_OUT robotout = { 0 };
-ROBOT_IN robotin = { 0 };
+JSON_CONFIG robotConfig = { 0 };
+/** Guards #robotConfig, which is published from both the main loop and the connection listener */
+pthread_mutex_t robotConfigMutex = PTHREAD_MUTEX_INITIALIZER;
+/** Every tick reported by the robot since the previous loop */
+TELEMETRY_RECORD history[TELEMETRY_HISTORY_SIZE];
 SharedMemory *sm;
 ERROR_LEVEL lastErrorLevel = EL_NO_ERROR;
 json robotStatus;
+json loopStats;
+json profiles;
 
 int main() {
 	printCommandInformation();
 	sm = new SharedMemory();
 	sendDefaultConfig();
+	moveOffRealtimeCpu();
 	int rc;
 	//Create thread
 	pthread_t thread;
@@ -76,11 +88,9 @@ int main() {
 		exit(1);
 	}
 	struct timespec timespec;
-	clock_gettime(CLOCK_MONOTONIC, &timespec);
-	timespec.tv_nsec += NANO_INC;
-	tsnorm(&timespec);
 	ROBOT_OUT oldStatus;
 	oldStatus.block_number = -1;
+	TELEMETRY_RECORD lastRecord = { 0 };
 
 	std::string filename = "Data/positionData.txt";
 	std::ofstream file;
@@ -88,15 +98,15 @@ int main() {
 	bool shouldWrite = false;
 
 	while (true) {
-		static int clockReturn = 0;
-		clockReturn = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &timespec, NULL);
-		if (clockReturn != 0) {
-			//if (clockReturn != EINTR)
-			printf("clock_nanosleep failed. errno: %d clockReturn: %d\n", errno, clockReturn);
-			break;
-		}
-		timespec.tv_nsec += NANO_INC;
+		// Sleep until the robot publishes a change, the history is replayed below either way
+		clock_gettime(CLOCK_MONOTONIC, &timespec);
+		timespec.tv_nsec += STATUS_REFRESH_NSEC;
 		tsnorm(&timespec);
+		int waitReturn = sm->waitForStatus(&timespec);
+		if (waitReturn != 0 && waitReturn != ETIMEDOUT && waitReturn != EINTR) {
+			//Keep the refresh rate rather than spin on a broken wait
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &timespec, NULL);
+		}
 
 		bool newData = sm->readRobotOut(&robotout);
 		if (newData) {
@@ -118,54 +128,50 @@ int main() {
 			displayErrors(robotout);
 			lastErrorLevel = robotout.operatingErrors.priorityError;
 
-			oldStatus.block_number = robotout.block_number;
-			if (robotout.pc_status.itemsPicked != oldStatus.pc_status.itemsPicked
-					|| robotout.pc_status.state != oldStatus.pc_status.state) {
+			oldStatus = robotout;
+		}
+
+		// Replay every tick since the last poll, so transitions shorter than a poll are not missed
+		unsigned int records = sm->readTelemetry(history, TELEMETRY_HISTORY_SIZE);
+		for (unsigned int index = 0; index < records; index++) {
+			TELEMETRY_RECORD *record = &history[index];
+			if (record->itemsPicked != lastRecord.itemsPicked || record->pickState != lastRecord.pickState) {
 				if (robotout.runtimeFlags.logAxesData) {
-					loggedValues << robotout.block_number << " Number of items picked: " <<
-						robotout.pc_status.itemsPicked << " Status state: " << getPickStatusString(robotout.pc_status.state) << "\n";
+					loggedValues << record->block_number << " Number of items picked: " <<
+						record->itemsPicked << " Status state: " << getPickStatusString((PICK_STATE) record->pickState) << "\n";
 					shouldWrite = true;
 				}
-				printf("(%ld) Number of items picked: %ld Status state: %s\n", robotout.block_number,
-						robotout.pc_status.itemsPicked, getPickStatusString(robotout.pc_status.state).c_str());
+				printf("(%ld) Number of items picked: %d Status state: %s\n", record->block_number,
+						record->itemsPicked, getPickStatusString((PICK_STATE) record->pickState).c_str());
 
 				if (robotout.runtimeFlags.logAxesData) {
-					loggedValues << robotout.axisStatus.axisPosition[0] << ", " <<
-							robotout.axisStatus.axisPosition[1] << ", " <<
-							robotout.axisStatus.axisPosition[2] << "\n";
+					loggedValues << record->axisPosition[0] << ", " <<
+							record->axisPosition[1] << ", " <<
+							record->axisPosition[2] << "\n";
 				}
-				if (!robotout.axisStatus.isBusy) {//Comment out this line to print live feed of position data. Otherwise prints endpoints
-					loggedValues << "Currently " << (robotout.axisStatus.isBusy ? "Moving" : "Idle") << "\n";
+				if (!record->isBusy) {//Comment out this line to print live feed of position data. Otherwise prints endpoints
+					loggedValues << "Currently " << (record->isBusy ? "Moving" : "Idle") << "\n";
 					shouldWrite = true;
 
-					printf("Currently %s X: %d Y: %d Z: %d\n", robotout.axisStatus.isBusy ? "Moving" : "Idle",
-							robotout.axisStatus.axisPosition[0], robotout.axisStatus.axisPosition[1],
-							robotout.axisStatus.axisPosition[2]);
+					printf("Currently %s X: %d Y: %d Z: %d\n", record->isBusy ? "Moving" : "Idle",
+							record->axisPosition[0], record->axisPosition[1],
+							record->axisPosition[2]);
 				}
 			}
 
-			if (robotout.vacStatus.suctionStatus != oldStatus.vacStatus.suctionStatus
-					|| abs(robotout.vacStatus.sensorValue - oldStatus.vacStatus.sensorValue) > 5) {
+			if (record->suctionStatus != lastRecord.suctionStatus
+					|| fabs(record->sensorValue - lastRecord.sensorValue) > 5) {
 				if (robotout.runtimeFlags.logAxesData) {
-					loggedValues << "Suction on: " << (robotout.vacStatus.isVacuumOn ? "true" : "false") << "\n";
-					loggedValues << "Suction: " << robotout.vacStatus.sensorValue << " = " << getSuctionString(robotout.vacStatus.suctionStatus) << "\n";
+					loggedValues << "Suction on: " << (record->isVacuumOn ? "true" : "false") << "\n";
+					loggedValues << "Suction: " << record->sensorValue << " = " << getSuctionString((SUCTION) record->suctionStatus) << "\n";
 					shouldWrite = true;
 				}
-				printf("Suction on: %s\n", robotout.vacStatus.isVacuumOn ? "true" : "false");
-				printf("Suction: %f = %s\n", robotout.vacStatus.sensorValue,
-						getSuctionString(robotout.vacStatus.suctionStatus).c_str());
+				printf("Suction on: %s\n", record->isVacuumOn ? "true" : "false");
+				printf("Suction: %f = %s\n", record->sensorValue,
+						getSuctionString((SUCTION) record->suctionStatus).c_str());
 			}
-			oldStatus = robotout;
-		}
-		if (sendCommand) {
-			robotin.block_number++;
-			robotin.commandStruct.command = command;
-			memcpy(robotin.commandStruct.axisCommand, target, sizeof(int) * 3);
-			sm->writeRobotIn(&robotin);
-			printf("Sent command to robot\n");
-			sendCommand = false;
+			lastRecord = *record;
 		}
-
 		if (shouldWrite) {
 			writeToFile(file, loggedValues.str()) ;
 			loggedValues.str(std::string());
@@ -180,6 +186,8 @@ json *robotStatusToJSON(json *jsonObj, ROBOT_OUT robotout) {
 			{ "runtimeFlags", {
 					{ "realtime", robotout.runtimeFlags.realtime },
 					{ "simulated", robotout.runtimeFlags.simulate },
+					{ "simSpeedup", robotout.runtimeFlags.simSpeedup },
+					{ "blendMotion", robotout.runtimeFlags.blendMotion },
 					{ "ignoreErrorFlags", robotout.runtimeFlags.ignoreErrorFlags }
 			}},
 			{ "pickControlStatus", {
@@ -187,6 +195,10 @@ json *robotStatusToJSON(json *jsonObj, ROBOT_OUT robotout) {
 					{ "itemsPicked", robotout.pc_status.itemsPicked },
 					{ "isZeroed", robotout.pc_status.state != PC_NEEDS_ZERO }
 			}},
+			{ "zeroReturnStatus", {
+					{ "homing", robotout.zrStatus.isHoming },
+					{ "homingMs", robotout.zrStatus.homingMs }
+			}},
 			{ "axisStatus", {
 					{ "currentPostion", {
 							{ "X", robotout.axisStatus.axisPosition[X] },
@@ -197,6 +209,11 @@ json *robotStatusToJSON(json *jsonObj, ROBOT_OUT robotout) {
 							{ "X", robotout.axisStatus.targetPosition[X] },
 							{ "Y", robotout.axisStatus.targetPosition[Y] },
 							{ "Z", robotout.axisStatus.targetPosition[Z] }
+					}},
+					{ "etaMs", {
+							{ "X", robotout.axisStatus.etaMs[X] },
+							{ "Y", robotout.axisStatus.etaMs[Y] },
+							{ "Z", robotout.axisStatus.etaMs[Z] }
 					}}
 			}},
 			{ "vacuumStatus", {
@@ -204,6 +221,25 @@ json *robotStatusToJSON(json *jsonObj, ROBOT_OUT robotout) {
 					{ "suctionStatus", getSuctionString(robotout.vacStatus.suctionStatus).c_str() },
 					{ "sensorValue", robotout.vacStatus.sensorValue }
 			}},
+			{ "realtimeStatus", {
+					{ "memoryLocked", robotout.rtStatus.memoryLocked },
+					{ "stackPrefaulted", robotout.rtStatus.stackPrefaulted },
+					{ "heapPrefaulted", robotout.rtStatus.heapPrefaulted },
+					{ "cpuPinned", robotout.rtStatus.cpuPinned },
+					{ "cpuIsolated", robotout.rtStatus.cpuIsolated },
+					{ "priorityFifo", robotout.rtStatus.priorityFifo },
+					{ "cpu", robotout.rtStatus.cpu },
+					{ "scheduleBudgetUs", robotout.rtStatus.scheduleBudgetUs },
+					{ "scheduleWorstTickUs", robotout.rtStatus.scheduleWorstTickUs }
+			}},
+			{ "ipcStatus", {
+					{ "robotTornReads", robotout.ipcStatus.tornReads },
+					{ "appTornReads", sm->getTornReads() },
+					{ "commandsProcessed", robotout.ipcStatus.commandsProcessed },
+					{ "commandsDropped", robotout.ipcStatus.commandsDropped },
+					{ "historyRecords", robotout.ipcStatus.historyRecords },
+					{ "historyLost", sm->getHistoryLost() }
+			}},
 			{ "inErrorState", robotout.operatingErrors.numberOfErrors > 0 },
 			{ "emergencyStop", robotout.runtimeFlags.emergencyStop }
 	};
@@ -227,6 +263,65 @@ json *robotStatusToJSON(json *jsonObj, ROBOT_OUT robotout) {
 	return jsonObj;
 }
 
+json *loopStatsToJSON(json *jsonObj, ROBOT_OUT robotout) {
+	*jsonObj = {
+			{ "ticks", robotout.loopStats.ticks },
+			{ "overruns", robotout.loopStats.overruns },
+			{ "wakeupLatency", loopHistogramToJSON(&robotout.loopStats.wakeupLatency) },
+			{ "execution", loopHistogramToJSON(&robotout.loopStats.execution) },
+			{ "busTransactions", robotout.loopStats.busTransactions },
+			{ "busTransactionsPerTick", robotout.loopStats.ticks > 0 ?
+					(double) robotout.loopStats.busTransactions / robotout.loopStats.ticks : 0.0 },
+			{ "busTransactionsMaxPerTick", robotout.loopStats.busTransactionsMax },
+			{ "ioRequestsDropped", robotout.loopStats.ioRequestsDropped }
+	};
+	return jsonObj;
+}
+
+json loopHistogramToJSON(const LOOP_HISTOGRAM *histogram) {
+	// Only non-empty buckets, in order, with their upper bound in microseconds
+	json buckets = json::array();
+	for (int bucket = 0; bucket < LOOP_HISTOGRAM_BUCKETS; bucket++) {
+		if (histogram->buckets[bucket] > 0) {
+			buckets.push_back({ { "belowUs", loopHistogramBucketLimit(bucket) }, { "count", histogram->buckets[bucket] } });
+		}
+	}
+	return {
+			{ "maxUs", histogram->maxNs / 1000.0 },
+			{ "p50Us", loopHistogramPercentile(histogram, 0.5) },
+			{ "p99Us", loopHistogramPercentile(histogram, 0.99) },
+			{ "p999Us", loopHistogramPercentile(histogram, 0.999) },
+			{ "buckets", buckets }
+	};
+}
+
+json *profilesToJSON(json *jsonObj, ROBOT_OUT robotout) {
+	json components = json::array();
+	for (int index = 0; index < robotout.profiles.numberOfComponents; index++) {
+		COMPONENT_PROFILE *profile = &robotout.profiles.components[index];
+		components.push_back({
+				{ "name", profile->name },
+				{ "step", profileStatsToJSON(&profile->step) },
+				{ "reportStatus", profileStatsToJSON(&profile->report) }
+		});
+	}
+	*jsonObj = {
+			{ "window", robotout.profiles.window },
+			{ "windowTicks", robotout.profiles.windowTicks },
+			{ "components", components }
+	};
+	return jsonObj;
+}
+
+json profileStatsToJSON(const PROFILE_STATS *stats) {
+	return {
+			{ "minNs", stats->minNs },
+			{ "avgNs", stats->avgNs },
+			{ "maxNs", stats->maxNs },
+			{ "p99Ns", stats->p99Ns }
+	};
+}
+
 void printCommandInformation() {
 	printf("Command Help:\n");
 	printf("estop:\t\tImmediately stops machine motion and requires a zero return to resume picking.\n");
@@ -237,6 +332,8 @@ void printCommandInformation() {
 			"newbox:\t\tResets the target generation to the top of the box. This is necessary after all pick locations have been attempted.\n");
 	printf(
 			"status:\t\tReports the current state of the machine and number of items picked.\n");
+	printf("stats:\t\tReports the real-time loop's wakeup latency and execution time histograms.\n");
+	printf("profile:\tReports each component's step and reportStatus execution times over the last window.\n");
 	printf("zero:\t\tZero returns the machine.\n");
 	printf("zneeded:\tZero returns the machine only if it is needed.\n");
 }
@@ -260,12 +357,37 @@ void sendDefaultConfig() {
 		printf("/home/pi/default_config.json is missing.\n");
 		exit(1);
 	}
-	configParser.parseConfig(&robotin, &fileConfig);
-	robotin.block_number++;
-	sm->writeRobotIn(&robotin);
+	pthread_mutex_lock(&robotConfigMutex);
+	configParser.parseConfig(&robotConfig, &fileConfig);
+	sm->writeConfig(&robotConfig);
+	pthread_mutex_unlock(&robotConfigMutex);
 	printf("Configuration sent.\n");
 }
 
+/**
+ * Keep this process (and the threads it creates afterwards, including logging)
+ * off the core reserved for the pick-robot's real-time loop.
+ */
+void moveOffRealtimeCpu() {
+	if (!robotConfig.runtimeFlags.realtime) {
+		return;
+	}
+	int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int realtimeCpu = robotConfig.runtimeFlags.realtimeCpu < 0 ? cpus - 1 : robotConfig.runtimeFlags.realtimeCpu;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu = 0; cpu < cpus; cpu++) {
+		if (cpu != realtimeCpu) {
+			CPU_SET(cpu, &set);
+		}
+	}
+	if (CPU_COUNT(&set) == 0 || sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+		printf("Could not move off real-time CPU %d.\n", realtimeCpu);
+	} else {
+		printf("Running off real-time CPU %d.\n", realtimeCpu);
+	}
+}
+
 std::string getPickStatusString(PICK_STATE status) {
 	switch (status) {
 		case PC_VAC_ON:
@@ -357,29 +479,52 @@ void *connectionListener(void*) {
 			perror("accept");
 		}
 		while (true) {
-			valread = read(new_socket, buffer, 1024);
-			buffer[1023] = 0;
+			valread = read(new_socket, buffer, 1023);
 			if (valread > 0) {
-				if (!sendCommand) {
-					parseStringForCommand(buffer, valread);
-					if (sendCommand) {
-						printf("%s: Command sent by client: %d\n", inet_ntoa(address.sin_addr), command);
+				buffer[valread] = 0;
+				// A client may pipeline several commands, one per line, in a single packet
+				char *line = buffer;
+				int lineLength = valread;
+				while (lineLength > 0) {
+					char *end = compareCommands(line, "json=") ? NULL : (char *) memchr(line, '\n', lineLength);
+					int length = end ? end - line : lineLength;
+					line[length] = 0;
+					COMMAND_STRUCT command = {};
+					if (parseStringForCommand(line, length, &command)) {
+						if (sm->pushCommand(&command)) {
+							printf("%s: Command queued by client: %d\n", inet_ntoa(address.sin_addr), command.command);
+						} else {
+							printf("%s: Command dropped, robot command queue is full: %d\n", inet_ntoa(address.sin_addr), command.command);
+						}
 					}
+					line += length + 1;
+					lineLength -= length + 1;
 				}
 				if (compareCommands(buffer, "exit")) {
 					close(new_socket);
 					break;
 				}
+				// Replies are built as strings, the status with its errors outgrows the buffer
 				if (compareCommands(buffer, "status")) {
-					int size = snprintf(buffer, bufferLength, "\n%s\n %s\n", "======== Status ========",
-							robotStatusToJSON(&robotStatus, robotout)->dump().c_str());
-					send(new_socket, buffer, size, MSG_DONTWAIT);
+					std::string reply = "\n======== Status ========\n " +
+							robotStatusToJSON(&robotStatus, robotout)->dump() + "\n";
+					send(new_socket, reply.c_str(), reply.size(), MSG_DONTWAIT);
+				}
+				if (compareCommands(buffer, "stats")) {
+					std::string reply = "\n======== Loop Statistics ========\n " +
+							loopStatsToJSON(&loopStats, robotout)->dump() + "\n";
+					send(new_socket, reply.c_str(), reply.size(), MSG_DONTWAIT);
+				}
+				if (compareCommands(buffer, "profile")) {
+					std::string reply = "\n======== Component Profile ========\n " +
+							profilesToJSON(&profiles, robotout)->dump() + "\n";
+					send(new_socket, reply.c_str(), reply.size(), MSG_DONTWAIT);
 				}
 				if (compareCommands(buffer, "pstatus")) {
 					int prettyPrint = 4;
-					int size = snprintf(buffer, bufferLength, "\n%s\n %s\n", "======== Status ========",
-							robotStatusToJSON(&robotStatus, robotout)->dump(prettyPrint).c_str()); // Pretty printing
-					send(new_socket, buffer, size, MSG_DONTWAIT);
+					std::string reply = "\n======== Status ========\n " +
+							robotStatusToJSON(&robotStatus, robotout)->dump(prettyPrint) + "\n"; // Pretty printing
+					send(new_socket, reply.c_str(), reply.size(), MSG_DONTWAIT);
 				}
 			}
 		}
@@ -392,7 +537,7 @@ bool compareCommands(char * str1, const char *str2) {
 	return length <= strlen(str1) && strncmp(str1, str2, length) == 0;
 }
 
-void parseStringForCommand(char *buffer, int length) {
+bool parseStringForCommand(char *buffer, int length, COMMAND_STRUCT *command) {
 	bool hasComma = false;
 	for (int i = 0; i < length; i++) {
 		if (buffer[i] == ',') {
@@ -401,64 +546,66 @@ void parseStringForCommand(char *buffer, int length) {
 		}
 	}
 	if (compareCommands(buffer, "json={")) {
-		sendCommand = true;
-		command = COMMAND_LOAD_CONFIG;
+		// Publish the config first, the robot applies it when it pops COMMAND_LOAD_CONFIG
+		command->command = COMMAND_LOAD_CONFIG;
 		json json;
 		configParser.loadJSONFromString(std::string(buffer).substr(5), &json);
-		configParser.parseConfig(&robotin, &json);
+		pthread_mutex_lock(&robotConfigMutex);
+		configParser.parseConfig(&robotConfig, &json);
+		sm->writeConfig(&robotConfig);
+		pthread_mutex_unlock(&robotConfigMutex);
 	}
 
 	else if (!hasComma) {
-		sendCommand = true;
 		if (compareCommands(buffer, "estop")) {
-			command = COMMAND_EMERGENCY_STOP;
+			command->command = COMMAND_EMERGENCY_STOP;
 		} else if (compareCommands(buffer, "pick")) {
-			command = COMMAND_PICK_ITEM;
+			command->command = COMMAND_PICK_ITEM;
 		} else if (compareCommands(buffer, "vcon")) {
-			command = COMMAND_VAC_ON;
+			command->command = COMMAND_VAC_ON;
 		} else if (compareCommands(buffer, "vcoff")) {
-			command = COMMAND_VAC_OFF;
+			command->command = COMMAND_VAC_OFF;
 		} else if (compareCommands(buffer, "zero")) {
-			command = COMMAND_ZERO_RETURN;
+			command->command = COMMAND_ZERO_RETURN;
 		} else if (compareCommands(buffer, "zstg")) {
-			command = COMMAND_ZERO_STAGE;
+			command->command = COMMAND_ZERO_STAGE;
 		} else if (compareCommands(buffer, "zneeded")) {
-			command = COMMAND_ZERO_IF_NEEDED;
+			command->command = COMMAND_ZERO_IF_NEEDED;
 		} else if (compareCommands(buffer, "drop")) {
-			command = COMMAND_DROP_ITEM;
+			command->command = COMMAND_DROP_ITEM;
 		} else if (compareCommands(buffer, "reset")) {
-			command = COMMAND_RESET;
+			command->command = COMMAND_RESET;
 		} else if (compareCommands(buffer, "newbox")) {
-			command = COMMAND_NEW_BOX_ADDED;
+			command->command = COMMAND_NEW_BOX_ADDED;
 		} else {
-			sendCommand = false;
+			return false;
 		}
 
 	} else {
 		//Positive values are invalid - valid will be commanded
-		memcpy(target, invalidTarget, sizeof(int) * 3);
+		memcpy(command->axisCommand, invalidTarget, sizeof(int) * 3);
 
 		if (compareCommands(buffer, "target=")) {
 			buffer += sizeof(char) * strlen("target=");
-			command = COMMAND_TARGET;
+			command->command = COMMAND_TARGET;
 		}
 		else if (compareCommands(buffer, "place=")) {
 			buffer += sizeof(char) * strlen("place=");
-			command = COMMAND_PLACE;
+			command->command = COMMAND_PLACE;
 		}
 		else {
-			command = COMMAND_AXIS;
+			command->command = COMMAND_AXIS;
 		}
 
-		target[0] = strtol(buffer, NULL, 10);
+		command->axisCommand[0] = strtol(buffer, NULL, 10);
 		if (nextInt(&buffer)) {
-			target[1] = strtol(buffer, NULL, 10);
+			command->axisCommand[1] = strtol(buffer, NULL, 10);
 			if (nextInt(&buffer)) {
-				target[2] = strtol(buffer, NULL, 10);
+				command->axisCommand[2] = strtol(buffer, NULL, 10);
 			}
 		}
-		sendCommand = true;
 	}
+	return true;
 }
 
 bool nextInt(char** buffer) {
@@ -496,6 +643,8 @@ std::string getErrorFlag(ERROR_STATUS error) {
 			return "EF_AXIS_TARGET_OUT_OF_BOUNDS";
 		case ES_VACUUM_SENSOR_MISREAD:
 			return "ES_VACUUM_SENSOR_MISREAD";
+		case ES_IO_REQUEST_DROPPED:
+			return "EF_IO_REQUEST_DROPPED";
 		default: return "BAD_ERROR";
 	}
 }
@@ -550,6 +699,8 @@ std::string getErrorInfo(ERROR_STATUS status) {
 			return "Commanded target is out of bounds.";
 		case ES_VACUUM_SENSOR_MISREAD:
 			return "Vacuum sensor misread.";
+		case ES_IO_REQUEST_DROPPED:
+			return "The I/O worker's request queue was full. A motor or gripper request was lost.";
 		default: return "BAD_ERROR_STATUS";
 	}
 }